@@ -4,78 +4,111 @@
 #include <math.h>
 #pragma IMAGINET_INCLUDES_END
 
-// Float32 to other types - Clamp mode
+// Float32 to 8/16-bit integer types
+// These conversions avoid per-element libm calls (roundf, fminf, fmaxf) and data-dependent
+// branches: the value is rounded first and saturated in the integer domain. Since every step is
+// monotonic and the bounds are integers, this gives the same result as clamping first.
+#pragma IMAGINET_FRAGMENT_BEGIN "cast_round"
+// roundf() (halfway cases away from zero) converted to int32, valid for |v| < 2^31: truncate,
+// then step away from zero when the discarded fraction is at least one half. v - t is exact, so
+// the result is identical to (int32_t)roundf(v).
+static inline int32_t cast_round_f32(float v)
+{
+    const int32_t t = (int32_t)v;
+    const float frac = v - (float)t;
+    return t + (frac >= 0.5f) - (frac <= -0.5f);
+}
+
+// Keeps v inside [-bound, bound] so it converts to int32 safely, and replaces NaN by nan_value.
+// The bounds lie well outside the useful input range, so these branches are predictable.
+static inline float cast_guard_f32(float v, float bound, float nan_value)
+{
+    v = v == v ? v : nan_value;
+    v = v > bound ? bound : v;
+    v = v < -bound ? -bound : v;
+    return v;
+}
+
+static inline int32_t cast_saturate(int32_t v, int32_t lo, int32_t hi)
+{
+    v = v > hi ? hi : v;
+    return v < lo ? lo : v;
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i8_clamp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i8_clamp(const float* restrict input, int8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
-        // Clamp to int8 range and round
-        float val = roundf(input[i]);
-        if (val > 127.0f) val = 127.0f;
-        else if (val < -128.0f) val = -128.0f;
-        output[i] = (int8_t)val;
+        // Round and clamp to int8 range
+        const float val = cast_guard_f32(input[i], 1073741824.0f, 0.0f);
+        output[i] = (int8_t)cast_saturate(cast_round_f32(val), INT8_MIN, INT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i8_range_0_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i8_range_0_1(const float* restrict input, int8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [0.0, 1.0] to [-128, 127]
-        // First clamp to [0,1], then map to signed range
-        float normalized = fmaxf(0.0f, fminf(1.0f, input[i]));
-        output[i] = (int8_t)roundf(normalized * 255.0f - 128.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (int8_t)cast_saturate(cast_round_f32(normalized * 255.0f - 128.0f), INT8_MIN, INT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i8_range_neg1_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i8_range_neg1_1(const float* restrict input, int8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [-1.0, 1.0] to [-128, 127]
-        float normalized = fmaxf(-1.0f, fminf(1.0f, input[i]));
-        output[i] = (int8_t)roundf(normalized * 127.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (int8_t)cast_saturate(cast_round_f32(normalized * 127.0f), -INT8_MAX, INT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i16_clamp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i16_clamp(const float* restrict input, int16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
-        // Clamp to int16 range and round
-        float val = roundf(input[i]);
-        if (val > 32767.0f) val = 32767.0f;
-        else if (val < -32768.0f) val = -32768.0f;
-        output[i] = (int16_t)val;
+        // Round and clamp to int16 range
+        const float val = cast_guard_f32(input[i], 1073741824.0f, 0.0f);
+        output[i] = (int16_t)cast_saturate(cast_round_f32(val), INT16_MIN, INT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i16_range_0_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i16_range_0_1(const float* restrict input, int16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [0.0, 1.0] to [-32768, 32767]
-        float normalized = fmaxf(0.0f, fminf(1.0f, input[i]));
-        output[i] = (int16_t)roundf(normalized * 65535.0f - 32768.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (int16_t)cast_saturate(cast_round_f32(normalized * 65535.0f - 32768.0f), INT16_MIN, INT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i16_range_neg1_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_i16_range_neg1_1(const float* restrict input, int16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [-1.0, 1.0] to [-32768, 32767]
-        float normalized = fmaxf(-1.0f, fminf(1.0f, input[i]));
-        output[i] = (int16_t)roundf(normalized * 32767.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (int16_t)cast_saturate(cast_round_f32(normalized * 32767.0f), -INT16_MAX, INT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
+// Float32 to 32-bit integer types
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_i32_clamp"
 static inline void cast_f32_to_i32_clamp(const float* restrict input, int32_t* restrict output, int32_t count)
 {
@@ -112,71 +145,73 @@ static inline void cast_f32_to_i32_range_neg1_1(const float* restrict input, int
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u8_clamp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u8_clamp(const float* restrict input, uint8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
-        // Clamp to uint8 range and round
-        float val = roundf(input[i]);
-        if (val > 255.0f) val = 255.0f;
-        else if (val < 0.0f) val = 0.0f;
-        output[i] = (uint8_t)val;
+        // Round and clamp to uint8 range
+        const float val = cast_guard_f32(input[i], 1073741824.0f, 0.0f);
+        output[i] = (uint8_t)cast_saturate(cast_round_f32(val), 0, UINT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u8_range_0_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u8_range_0_1(const float* restrict input, uint8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [0.0, 1.0] to [0, 255]
-        float normalized = fmaxf(0.0f, fminf(1.0f, input[i]));
-        output[i] = (uint8_t)roundf(normalized * 255.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (uint8_t)cast_saturate(cast_round_f32(normalized * 255.0f), 0, UINT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u8_range_neg1_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u8_range_neg1_1(const float* restrict input, uint8_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [-1.0, 1.0] to [0, 255]
-        float normalized = fmaxf(-1.0f, fminf(1.0f, input[i]));
-        output[i] = (uint8_t)roundf((normalized + 1.0f) * 127.5f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (uint8_t)cast_saturate(cast_round_f32((normalized + 1.0f) * 127.5f), 0, UINT8_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u16_clamp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u16_clamp(const float* restrict input, uint16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
-        // Clamp to uint16 range and round
-        float val = roundf(input[i]);
-        if (val > 65535.0f) val = 65535.0f;
-        else if (val < 0.0f) val = 0.0f;
-        output[i] = (uint16_t)val;
+        // Round and clamp to uint16 range
+        const float val = cast_guard_f32(input[i], 1073741824.0f, 0.0f);
+        output[i] = (uint16_t)cast_saturate(cast_round_f32(val), 0, UINT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u16_range_0_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u16_range_0_1(const float* restrict input, uint16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [0.0, 1.0] to [0, 65535]
-        float normalized = fmaxf(0.0f, fminf(1.0f, input[i]));
-        output[i] = (uint16_t)roundf(normalized * 65535.0f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (uint16_t)cast_saturate(cast_round_f32(normalized * 65535.0f), 0, UINT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "cast_f32_to_u16_range_neg1_1"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "cast_round"
 static inline void cast_f32_to_u16_range_neg1_1(const float* restrict input, uint16_t* restrict output, int32_t count)
 {
     for (int i = 0; i < count; i++) {
         // Range conversion: map [-1.0, 1.0] to [0, 65535]
-        float normalized = fmaxf(-1.0f, fminf(1.0f, input[i]));
-        output[i] = (uint16_t)roundf((normalized + 1.0f) * 32767.5f);
+        const float normalized = cast_guard_f32(input[i], 2.0f, 1.0f);
+        output[i] = (uint16_t)cast_saturate(cast_round_f32((normalized + 1.0f) * 32767.5f), 0, UINT16_MAX);
     }
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,153 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "elementwise_chain"
+
+#define ELEMENTWISE_CHAIN_BLOCK 256   // Elements per block, small enough to stay in L1 between stages
+
+// Stage flags, applied in this order
+#define ELEMENTWISE_CHAIN_ADD   1     // x + A
+#define ELEMENTWISE_CHAIN_SCALE 2     // x * scale
+#define ELEMENTWISE_CHAIN_POW   4     // x ^ exponent
+#define ELEMENTWISE_CHAIN_LOG   8     // log(x) * log_scale
+#define ELEMENTWISE_CHAIN_LOG10 16    // log10(x)
+#define ELEMENTWISE_CHAIN_CLIP  32    // min <= x <= max
+#define ELEMENTWISE_CHAIN_SUB   64    // B - x
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "elementwise_chain_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "elementwise_chain"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Pow/pow.h:pow_f32"
+
+// The input is processed in blocks of ELEMENTWISE_CHAIN_BLOCK elements. The first enabled stage
+// reads the input block, every following stage updates the output block in place while it is
+// still in cache, so each element is read from and written to memory once regardless of the
+// number of stages. Each stage is a separate tight loop and matches the standalone unit exactly;
+// the power stage runs pow_f32 of the Pow unit into a block buffer, since it must not work in place.
+static inline void elementwise_chain_f32(const float* restrict x, int count, int stages,
+	float add, float scale, float exponent, float log_scale, float min, float max, float sub,
+	float* restrict output)
+{
+	float block[ELEMENTWISE_CHAIN_BLOCK];
+
+	for (int b = 0; b < count; b += ELEMENTWISE_CHAIN_BLOCK) {
+		const int len = count - b < ELEMENTWISE_CHAIN_BLOCK ? count - b : ELEMENTWISE_CHAIN_BLOCK;
+		const float* src = x + b;
+		float* y = output + b;
+
+		if (stages & ELEMENTWISE_CHAIN_ADD) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i] + add;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_SCALE) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i] * scale;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_POW) {
+			pow_f32(src, len, exponent, block);
+			src = block;
+		}
+		if (stages & ELEMENTWISE_CHAIN_LOG) {
+			for (int i = 0; i < len; i++) {
+				y[i] = logf(src[i]) * log_scale;
+			}
+			src = y;
+		}
+		else if (stages & ELEMENTWISE_CHAIN_LOG10) {
+			for (int i = 0; i < len; i++) {
+				y[i] = log10f(src[i]);
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_CLIP) {
+			for (int i = 0; i < len; i++) {
+				float value = src[i];
+				value = value > max ? max : value;
+				value = value < min ? min : value;
+				y[i] = value;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_SUB) {
+			for (int i = 0; i < len; i++) {
+				y[i] = sub - src[i];
+			}
+			src = y;
+		}
+
+		if (src != y) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i];
+			}
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "elementwise_chain_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "elementwise_chain"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Pow/pow.h:pow_i8"
+
+// Same block scheme as elementwise_chain_f32. Every stage narrows back to int8 exactly like the
+// standalone unit does (wrapping add/subtract, truncating scale, saturating power with pow_i8),
+// so the result is identical to chaining the units. The logarithm stages are not available for int8.
+static inline void elementwise_chain_i8(const int8_t* restrict x, int count, int stages,
+	int8_t add, float scale, float exponent, int8_t min, int8_t max, int8_t sub,
+	int8_t* restrict output)
+{
+	int8_t block[ELEMENTWISE_CHAIN_BLOCK];
+
+	for (int b = 0; b < count; b += ELEMENTWISE_CHAIN_BLOCK) {
+		const int len = count - b < ELEMENTWISE_CHAIN_BLOCK ? count - b : ELEMENTWISE_CHAIN_BLOCK;
+		const int8_t* src = x + b;
+		int8_t* y = output + b;
+
+		if (stages & ELEMENTWISE_CHAIN_ADD) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i] + add;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_SCALE) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i] * scale;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_POW) {
+			pow_i8(src, len, exponent, block);
+			src = block;
+		}
+		if (stages & ELEMENTWISE_CHAIN_CLIP) {
+			for (int i = 0; i < len; i++) {
+				int8_t value = src[i];
+				value = value > max ? max : value;
+				value = value < min ? min : value;
+				y[i] = value;
+			}
+			src = y;
+		}
+		if (stages & ELEMENTWISE_CHAIN_SUB) {
+			for (int i = 0; i < len; i++) {
+				y[i] = sub - src[i];
+			}
+			src = y;
+		}
+
+		if (src != y) {
+			for (int i = 0; i < len; i++) {
+				y[i] = src[i];
+			}
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
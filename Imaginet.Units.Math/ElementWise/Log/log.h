@@ -27,4 +27,65 @@ static inline void log10_f32(const float* restrict x, int count, float* restrict
 		*result++ = log10f(*x++);
 	}
 }
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "log_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "log_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "log10_f32"
+
+#define LOG_QUANTIZE_BLOCK 64
+
+// The quantized outputs compute the logarithm of a small block in float, exactly as the float
+// implementations do, and quantize it while it is in cache. This gives the same result as a
+// Logarithm unit followed by a Quantize unit without the float tensor in between.
+static inline void __log_block_f32(const float* restrict x, int count, int base10, float ilbase, float* restrict result)
+{
+	if (base10) {
+		log10_f32(x, count, result);
+	} else {
+		log_f32(x, count, ilbase, result);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "log_f32_to_q7"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "log_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q7"
+static inline void log_f32_to_q7(const float* restrict x, int count, int base10, float ilbase, int shift, q7_t* restrict result)
+{
+	float block[LOG_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += LOG_QUANTIZE_BLOCK) {
+		const int len = count - b < LOG_QUANTIZE_BLOCK ? count - b : LOG_QUANTIZE_BLOCK;
+		__log_block_f32(x + b, len, base10, ilbase, block);
+		quantize_f32_to_q7(block, result + b, len, shift);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "log_f32_to_q15"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "log_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q15"
+static inline void log_f32_to_q15(const float* restrict x, int count, int base10, float ilbase, int shift, q15_t* restrict result)
+{
+	float block[LOG_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += LOG_QUANTIZE_BLOCK) {
+		const int len = count - b < LOG_QUANTIZE_BLOCK ? count - b : LOG_QUANTIZE_BLOCK;
+		__log_block_f32(x + b, len, base10, ilbase, block);
+		quantize_f32_to_q15(block, result + b, len, shift);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "log_f32_to_q31"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "log_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q31"
+static inline void log_f32_to_q31(const float* restrict x, int count, int base10, float ilbase, int shift, q31_t* restrict result)
+{
+	float block[LOG_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += LOG_QUANTIZE_BLOCK) {
+		const int len = count - b < LOG_QUANTIZE_BLOCK ? count - b : LOG_QUANTIZE_BLOCK;
+		__log_block_f32(x + b, len, base10, ilbase, block);
+		quantize_f32_to_q31(block, result + b, len, shift);
+	}
+}
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma IMAGINET_INCLUDES_BEGIN
+#include <stddef.h>
 #include <stdint.h>
 #include <float.h>
+#include <math.h>
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "normalization_f32"
@@ -12,6 +14,83 @@ static inline void normalization_f32(const float* restrict x, int count, float*
 }
 #pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_q16"
+
+// (x - offset) / range for 8-bit inputs, truncated like the float to integer conversion, without
+// a division per element. Numerator and denominator are scaled by 2^16 and the division becomes a
+// multiplication with the rounded-up reciprocal 2^48 / range. It is only used when it gives the
+// same result as the float division, otherwise the float division is kept:
+// - offset and range are multiples of 2^-k for some k <= 16 (integers, for instance),
+// - (255 + |offset|) * 2^k < 2^24, so x - offset is exact in float and the float quotient only
+//   rounds, which never crosses an integer,
+// - (255 + |offset|) * |range| * 2^k < 2^32, so the error of the rounded-up reciprocal stays
+//   below the distance of the quotient to the next integer,
+// - the quotient stays below 2^14, so the 64-bit product does not overflow.
+typedef struct {
+	int64_t offset;     // offset * 2^16
+	int64_t recip;      // ceil(2^48 / |range * 2^16|)
+	int32_t negate;     // range < 0
+	int32_t fixed;      // 0 when the float division below is used
+	float offset_f;
+	float range_f;
+} normalization_q16;
+
+static inline normalization_q16 normalization_q16_make(float offset, float range)
+{
+	normalization_q16 q;
+	q.offset_f = offset;
+	q.range_f = range;
+
+	// |x - offset| <= 255 + |offset| for every int8 and uint8 x
+	const float span = 255.0f + fabsf(offset);
+	q.fixed = span < 16777216.0f && fabsf(range) < 16777216.0f && span < 16384.0f * fabsf(range);
+
+	// Smallest k with offset * 2^k and range * 2^k integral. Doubling is exact within the bounds.
+	int k = 0;
+	float so = offset, sr = range;
+	while (q.fixed && k < 16 && (floorf(so) != so || floorf(sr) != sr)) {
+		so *= 2.0f;
+		sr *= 2.0f;
+		k++;
+	}
+	q.fixed = q.fixed && floorf(so) == so && floorf(sr) == sr
+		&& ldexpf(span, k) < 16777216.0f && ldexpf(span * fabsf(range), k) < 4294967296.0f;
+	if (!q.fixed) {
+		q.offset = 0;
+		q.recip = 0;
+		q.negate = 0;
+		return q;
+	}
+
+	int64_t r = (int64_t)(range * 65536.0f);
+	q.negate = r < 0;
+	if (r < 0) r = -r;
+	q.offset = (int64_t)(offset * 65536.0f);
+	q.recip = ((INT64_C(1) << 48) + r - 1) / r;
+	return q;
+}
+
+// Always divides in float
+static inline normalization_q16 normalization_q16_make_float(float offset, float range)
+{
+	normalization_q16 q = normalization_q16_make(offset, range);
+	q.fixed = 0;
+	return q;
+}
+
+static inline int32_t normalization_q16_apply(normalization_q16 q, int32_t x)
+{
+	if (!q.fixed)
+		return (int32_t)((x - q.offset_f) / q.range_f);
+
+	const int64_t d = ((int64_t)x << 16) - q.offset;
+	const int64_t a = d < 0 ? -d : d;
+	const int32_t v = (int32_t)((a * q.recip) >> 48);
+	return (d < 0) != q.negate ? -v : v;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "normalization_i8"
 static inline void normalization_i8(const int8_t* restrict x, int count, int8_t* restrict output, float min, float max)
 {
@@ -47,4 +126,260 @@ static inline void batch_normalization_f32(const float* restrict x, int count, f
 		output[i] = (x[i] - min_val) / range;
 	}
 }
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_running"
+
+// Running min/max over a stream of tensors. Every tensor is scaled with the statistics of the
+// tensors before it, while its own min and max are gathered in the same loop and added afterwards,
+// so there is no second pass. The first tensor initializes the statistics from itself.
+//
+// Handle layout (size = 16 + window * 8 bytes):
+//   normalization_running_state header
+//   float ring[window][2]     min and max of the last 'window' tensors (window mode only)
+typedef struct {
+	float lo;           // running minimum
+	float hi;           // running maximum
+	int32_t tensors;    // number of tensors added so far
+	int32_t window;     // 0 for exponential weighting, else the number of tensors in the ring
+} normalization_running_state;
+
+static inline int normalization_running_init(int8_t* restrict handle, int window)
+{
+	normalization_running_state* state = (normalization_running_state*)handle;
+	state->lo = 0.0f;
+	state->hi = 1.0f;
+	state->tensors = 0;
+	state->window = window;
+	return 0;
+}
+
+// Statistics are frozen once 'warmup' tensors have been added (never when warmup is 0).
+static inline int normalization_running_frozen(const normalization_running_state* state, int warmup)
+{
+	return warmup > 0 && state->tensors >= warmup;
+}
+
+static inline void normalization_running_add(normalization_running_state* state, float lo, float hi, float alpha)
+{
+	if (state->window > 0) {
+		float* ring = (float*)(state + 1);
+		const int slot = state->tensors % state->window;
+		const int used = state->tensors < state->window ? state->tensors + 1 : state->window;
+		ring[2 * slot] = lo;
+		ring[2 * slot + 1] = hi;
+		for (int i = 0; i < used; i++) {
+			lo = ring[2 * i] < lo ? ring[2 * i] : lo;
+			hi = ring[2 * i + 1] > hi ? ring[2 * i + 1] : hi;
+		}
+		state->lo = lo;
+		state->hi = hi;
+	}
+	else if (state->tensors == 0) {
+		state->lo = lo;
+		state->hi = hi;
+	}
+	else {
+		state->lo += alpha * (lo - state->lo);
+		state->hi += alpha * (hi - state->hi);
+	}
+	state->tensors++;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_normalization_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_running"
+static inline void running_normalization_f32(const float* restrict x, int count, float* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	normalization_running_state* state = (normalization_running_state*)handle;
+	const int first = state->tensors == 0;
+	const int update = !first && !normalization_running_frozen(state, warmup);
+	float lo = x[0], hi = x[0];
+
+	if (first) {
+		for (int i = 1; i < count; i++) {
+			lo = x[i] < lo ? x[i] : lo;
+			hi = x[i] > hi ? x[i] : hi;
+		}
+		normalization_running_add(state, lo, hi, alpha);
+	}
+
+	const float min = state->lo;
+	const float range = state->hi - state->lo;
+	const float scale = range == 0.0f ? 1.0f : 1.0f / range;
+
+	if (!update) {
+		for (int i = 0; i < count; i++) {
+			output[i] = (x[i] - min) * scale;
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		const float v = x[i];
+		lo = v < lo ? v : lo;
+		hi = v > hi ? v : hi;
+		output[i] = (v - min) * scale;
+	}
+	normalization_running_add(state, lo, hi, alpha);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_8bit"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_q16"
+
+// Shared by the int8 and uint8 running fragments of Normalization and Standardization. Both
+// element types are passed as bytes with a signed flag: the flag only changes how a byte is
+// widened, and the low byte of the result is the same for an int8 and a uint8 output.
+typedef struct {
+	int32_t lo;
+	int32_t hi;
+	int64_t sum;
+	int64_t sum_sq;
+} running_8bit_stats;
+
+static inline int32_t __running_8bit_load(const uint8_t* restrict x, int i, int is_signed)
+{
+	return is_signed ? (int32_t)(int8_t)x[i] : (int32_t)x[i];
+}
+
+static inline void running_8bit_gather(const uint8_t* restrict x, int is_signed, int count, running_8bit_stats* stats)
+{
+	int32_t lo = __running_8bit_load(x, 0, is_signed), hi = lo;
+	int64_t sum = 0, sum_sq = 0;
+	for (int i = 0; i < count; i++) {
+		const int32_t v = __running_8bit_load(x, i, is_signed);
+		lo = v < lo ? v : lo;
+		hi = v > hi ? v : hi;
+		sum += v;
+		sum_sq += v * v;
+	}
+	stats->lo = lo;
+	stats->hi = hi;
+	stats->sum = sum;
+	stats->sum_sq = sum_sq;
+}
+
+// Scales every element with q. When stats is not NULL the statistics of x are gathered in the
+// same loop.
+static inline void running_8bit_apply(const uint8_t* restrict x, int is_signed, int count, uint8_t* restrict output,
+	normalization_q16 q, running_8bit_stats* stats)
+{
+	if (stats == NULL) {
+		for (int i = 0; i < count; i++) {
+			output[i] = (uint8_t)normalization_q16_apply(q, __running_8bit_load(x, i, is_signed));
+		}
+		return;
+	}
+
+	int32_t lo = __running_8bit_load(x, 0, is_signed), hi = lo;
+	int64_t sum = 0, sum_sq = 0;
+	for (int i = 0; i < count; i++) {
+		const int32_t v = __running_8bit_load(x, i, is_signed);
+		lo = v < lo ? v : lo;
+		hi = v > hi ? v : hi;
+		sum += v;
+		sum_sq += v * v;
+		output[i] = (uint8_t)normalization_q16_apply(q, v);
+	}
+	stats->lo = lo;
+	stats->hi = hi;
+	stats->sum = sum;
+	stats->sum_sq = sum_sq;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_normalization_8bit"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_running"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "running_8bit"
+static inline void __running_normalization_8bit(const uint8_t* restrict x, int is_signed, int count, uint8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	normalization_running_state* state = (normalization_running_state*)handle;
+	const int first = state->tensors == 0;
+	const int update = !first && !normalization_running_frozen(state, warmup);
+	running_8bit_stats stats;
+
+	if (first) {
+		running_8bit_gather(x, is_signed, count, &stats);
+		normalization_running_add(state, (float)stats.lo, (float)stats.hi, alpha);
+	}
+
+	const float range = state->hi - state->lo;
+	const normalization_q16 q = normalization_q16_make(state->lo, range == 0.0f ? 1.0f : range);
+
+	running_8bit_apply(x, is_signed, count, output, q, update ? &stats : NULL);
+	if (update)
+		normalization_running_add(state, (float)stats.lo, (float)stats.hi, alpha);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_normalization_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "running_normalization_8bit"
+static inline void running_normalization_i8(const int8_t* restrict x, int count, int8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	__running_normalization_8bit((const uint8_t*)x, 1, count, (uint8_t*)output, handle, alpha, warmup);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_normalization_u8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "running_normalization_8bit"
+static inline void running_normalization_u8(const uint8_t* restrict x, int count, uint8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	__running_normalization_8bit(x, 0, count, output, handle, alpha, warmup);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_q_output"
+#define NORMALIZATION_QUANTIZE_BLOCK 64
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_f32_to_q7"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q7"
+static inline void normalization_f32_to_q7(const float* restrict x, int count, q7_t* restrict output, float min, float max, int shift)
+{
+	float block[NORMALIZATION_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += NORMALIZATION_QUANTIZE_BLOCK) {
+		const int len = count - b < NORMALIZATION_QUANTIZE_BLOCK ? count - b : NORMALIZATION_QUANTIZE_BLOCK;
+		normalization_f32(x + b, len, block, min, max);
+		quantize_f32_to_q7(block, output + b, len, shift);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_f32_to_q15"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q15"
+static inline void normalization_f32_to_q15(const float* restrict x, int count, q15_t* restrict output, float min, float max, int shift)
+{
+	float block[NORMALIZATION_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += NORMALIZATION_QUANTIZE_BLOCK) {
+		const int len = count - b < NORMALIZATION_QUANTIZE_BLOCK ? count - b : NORMALIZATION_QUANTIZE_BLOCK;
+		normalization_f32(x + b, len, block, min, max);
+		quantize_f32_to_q15(block, output + b, len, shift);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "normalization_f32_to_q31"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "normalization_q_output"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_q.h:quantize_f32_to_q31"
+static inline void normalization_f32_to_q31(const float* restrict x, int count, q31_t* restrict output, float min, float max, int shift)
+{
+	float block[NORMALIZATION_QUANTIZE_BLOCK];
+	for (int b = 0; b < count; b += NORMALIZATION_QUANTIZE_BLOCK) {
+		const int len = count - b < NORMALIZATION_QUANTIZE_BLOCK ? count - b : NORMALIZATION_QUANTIZE_BLOCK;
+		normalization_f32(x + b, len, block, min, max);
+		quantize_f32_to_q31(block, output + b, len, shift);
+	}
+}
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
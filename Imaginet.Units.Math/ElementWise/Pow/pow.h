@@ -1,49 +1,260 @@
 ﻿#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "pow_special"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../Trigonometry/Sin/sin.h:trig_select"
+
+#define POW_MAX_INT_EXPONENT 4
+
+// Kernels for the exponents that are common in feature graphs: powers of spectra, RMS and
+// normalization. The exponent is inspected once per call and the matching loop below is run
+// instead of calling powf per element. Exponent 1 returns x; 2, -1 and 0.5 are correctly rounded
+// (x * x, 1 / x, sqrtf) and may differ by 1 ulp from a powf that is not. The other integer
+// exponents are computed by repeated multiplication and -0.5 as 1 / sqrt, which can differ from
+// powf by up to 2 ulp, and 1 / x^n is 0 where x^n overflows.
+
+// result = x^n for an integer 0 < n <= POW_MAX_INT_EXPONENT, by squaring. The tests of the bits
+// of n are the same for every element and are moved out of the loop by the compiler.
+static inline void __pow_int_f32(const float* restrict x, int count, int n, float* restrict result)
+{
+	for (int i = 0; i < count; i++) {
+		const float v = x[i];
+		const float v2 = v * v;
+		float r = n & 4 ? v2 * v2 : 1.0f;
+		r = n & 2 ? r * v2 : r;
+		r = n & 1 ? r * v : r;
+		result[i] = r;
+	}
+}
+
+// result = 1 / x^n for an integer 0 < n <= POW_MAX_INT_EXPONENT
+static inline void __pow_inverse_int_f32(const float* restrict x, int count, int n, float* restrict result)
+{
+	__pow_int_f32(x, count, n, result);
+	for (int i = 0; i < count; i++) {
+		result[i] = 1.0f / result[i];
+	}
+}
+
+// powf(x, 0.5) is +0 for -0 and +inf for -inf, where sqrtf gives -0 and NaN
+static inline float __pow_sqrt_f32(float x)
+{
+	return __trig_select_f32(0u - (uint32_t)(x == -INFINITY), INFINITY, sqrtf(x + 0.0f));
+}
+
+static inline void __pow_sqrt_loop_f32(const float* restrict x, int count, float* restrict result)
+{
+	for (int i = 0; i < count; i++) {
+		result[i] = __pow_sqrt_f32(x[i]);
+	}
+}
+
+static inline void __pow_rsqrt_loop_f32(const float* restrict x, int count, float* restrict result)
+{
+	for (int i = 0; i < count; i++) {
+		result[i] = 1.0f / __pow_sqrt_f32(x[i]);
+	}
+}
+
+// Runs the specialized kernel for exponent, returns 0 when there is none.
+static inline int __pow_special_f32(const float* restrict x, int count, float exponent, float* restrict result)
+{
+	if (exponent == 0.5f) {
+		__pow_sqrt_loop_f32(x, count, result);
+		return 1;
+	}
+	if (exponent == -0.5f) {
+		__pow_rsqrt_loop_f32(x, count, result);
+		return 1;
+	}
+	if (exponent == 0.0f) {
+		// powf(x, 0) is 1 for every x, NaN included
+		for (int i = 0; i < count; i++) {
+			result[i] = 1.0f;
+		}
+		return 1;
+	}
+	if (!(fabsf(exponent) <= (float)POW_MAX_INT_EXPONENT) || exponent != (float)(int)exponent) {
+		return 0;
+	}
+
+	const int n = (int)exponent;
+	if (n > 0) {
+		__pow_int_f32(x, count, n, result);
+	}
+	else {
+		__pow_inverse_int_f32(x, count, -n, result);
+	}
+	return 1;
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "pow_fast"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_special"
+
+// Polynomial log2 and exp2 for the general exponent, pow(x, y) = exp2(y * log2(|x|)). No libm
+// calls and no data-dependent branches, so the loop vectorizes. The relative error is about
+// 2e-7 * (1 + |log2(result)|): a few ulp for results near 1, up to some 1e-5 for results near
+// the limits of float. Denormal inputs and results are flushed to zero.
+
+// log2(x) for a finite x >= FLT_MIN. x = 2^e * m with m in [sqrt(1/2), sqrt(2)), and
+// log2(m) = 2 / ln(2) * atanh(t) with t = (m - 1) / (m + 1), |t| < 0.172.
+static inline float __pow_log2_f32(float x)
+{
+	uint32_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+	// Offsetting by the bits of sqrt(1/2) moves the exponent step from m = 2 to m = sqrt(2)
+	const uint32_t offset = bits - 0x3F3504F3u;
+	const int32_t e = (int32_t)offset >> 23;
+	bits = (offset & 0x007FFFFFu) + 0x3F3504F3u;
+
+	float m;
+	memcpy(&m, &bits, sizeof(m));
+	const float t = (m - 1.0f) / (m + 1.0f);
+	const float z = t * t;
+	const float p = ((0.41219858f * z + 0.57707801f) * z + 0.96179669f) * z + 2.88539008f;
+	return (float)e + t * p;
+}
+
+// 2^v, 0 below -126 and infinity from 128 up. v = n + f with n an integer and |f| <= 1/2, and
+// 2^n is applied as two factors so that n = 128 does not overflow the float exponent.
+static inline float __pow_exp2_f32(float v)
+{
+	const float limit = __trig_select_f32(0u - (uint32_t)(v >= 128.0f), INFINITY, 1.0f);
+	const float underflow = __trig_select_f32(0u - (uint32_t)(v < -126.0f), 0.0f, limit);
+	v = __trig_select_f32(0u - (uint32_t)(v > 127.99999f), 127.99999f, v);
+	v = __trig_select_f32(0u - (uint32_t)(v < -126.0f), -126.0f, v);
+
+	const float j = v + 12582912.0f;    // 1.5 * 2^23, adding it rounds to an integer
+	const float n = j - 12582912.0f;
+	const float f = v - n;
+	int32_t e;
+	memcpy(&e, &j, sizeof(e));
+	e -= 0x4B400000;
+	const uint32_t bits_low = (uint32_t)((e >> 1) + 127) << 23;
+	const uint32_t bits_high = (uint32_t)(e - (e >> 1) + 127) << 23;
+	float scale_low, scale_high;
+	memcpy(&scale_low, &bits_low, sizeof(scale_low));
+	memcpy(&scale_high, &bits_high, sizeof(scale_high));
+
+	// Taylor series of e^(f ln 2)
+	const float p = ((((((1.5252734e-5f * f + 1.5403530e-4f) * f + 1.3333558e-3f) * f + 9.6181291e-3f) * f + 5.5504109e-2f) * f + 2.4022651e-1f) * f + 6.9314718e-1f) * f + 1.0f;
+	return p * scale_low * scale_high * underflow;
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "pow_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_special"
 static inline void pow_f32(const float* restrict x, int count, float exponent, float* restrict result)
 {
+	if (__pow_special_f32(x, count, exponent, result)) {
+		return;
+	}
+	for (int i = 0; i < count; i++) {
+		result[i] = powf(x[i], exponent);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "pow_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_special"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_fast"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_f32"
+static inline void pow_fast_f32(const float* restrict x, int count, float exponent, float* restrict result)
+{
+	if (__pow_special_f32(x, count, exponent, result)) {
+		return;
+	}
+	if (exponent != exponent) {
+		pow_f32(x, count, exponent, result);
+		return;
+	}
+
+	// Results for the inputs the polynomials do not cover, computed once
+	const int is_int = floorf(exponent) == exponent;
+	const int is_odd = is_int && fabsf(exponent) < 16777216.0f && ((int32_t)exponent & 1);
+	const float negative = is_int ? (is_odd ? -1.0f : 1.0f) : NAN;
+	const float zero_result = exponent > 0.0f ? 0.0f : INFINITY;
+	const float inf_result = exponent > 0.0f ? INFINITY : 0.0f;
+	const uint32_t odd_mask = 0u - (uint32_t)is_odd;
+
 	for (int i = 0; i < count; i++) {
-		*result++ = powf(*x++, exponent);
+		const float v = x[i];
+		const float a = fabsf(v);
+		// Zero and infinity keep the sign of x for odd exponents
+		const float sign = __trig_select_f32(odd_mask, copysignf(1.0f, v), 1.0f);
+		float r = __pow_exp2_f32(exponent * __pow_log2_f32(a));
+		r = __trig_select_f32(0u - (uint32_t)(v < 0.0f), r * negative, r);
+		r = __trig_select_f32(0u - (uint32_t)(a < 1.17549435e-38f), zero_result * sign, r);
+		r = __trig_select_f32(0u - (uint32_t)(a == INFINITY), inf_result * sign, r);
+		result[i] = __trig_select_f32(0u - (uint32_t)(v != v), v, r);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "pow_int"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../FixedPoint/Quantize/quantize_d.h:quantize_sat"
+
+#define POW_INT_BLOCK 64
+
+// The integer types are converted to float a block at a time and go through pow_f32, so they
+// get the same exponent dispatch. The result is truncated and saturated to the type like Quantize.
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "pow_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_int"
 static inline void pow_i8(const int8_t* restrict x, int count, float exponent, int8_t* restrict result)
 {
-	for (int i = 0; i < count; i++) {
-		float val = powf((float)*x++, exponent);
-		if (val > 127.0f) val = 127.0f;
-		else if (val < -128.0f) val = -128.0f;
-		*result++ = (int8_t)val;
+	float in[POW_INT_BLOCK], out[POW_INT_BLOCK];
+	for (int c = 0; c < count; c += POW_INT_BLOCK) {
+		const int n = count - c < POW_INT_BLOCK ? count - c : POW_INT_BLOCK;
+		for (int i = 0; i < n; i++) {
+			in[i] = (float)x[c + i];
+		}
+		pow_f32(in, n, exponent, out);
+		for (int i = 0; i < n; i++) {
+			result[c + i] = __quantize_sat_i8(out[i]);
+		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "pow_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_int"
 static inline void pow_i16(const int16_t* restrict x, int count, float exponent, int16_t* restrict result)
 {
-	for (int i = 0; i < count; i++) {
-		float val = powf((float)*x++, exponent);
-		if (val > 32767.0f) val = 32767.0f;
-		else if (val < -32768.0f) val = -32768.0f;
-		*result++ = (int16_t)val;
+	float in[POW_INT_BLOCK], out[POW_INT_BLOCK];
+	for (int c = 0; c < count; c += POW_INT_BLOCK) {
+		const int n = count - c < POW_INT_BLOCK ? count - c : POW_INT_BLOCK;
+		for (int i = 0; i < n; i++) {
+			in[i] = (float)x[c + i];
+		}
+		pow_f32(in, n, exponent, out);
+		for (int i = 0; i < n; i++) {
+			result[c + i] = __quantize_sat_i16(out[i]);
+		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "pow_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "pow_int"
 static inline void pow_i32(const int32_t* restrict x, int count, float exponent, int32_t* restrict result)
 {
-	for (int i = 0; i < count; i++) {
-		float val = powf((float)*x++, exponent);
-		if (val > 2147483647.0f) val = 2147483647.0f;
-		else if (val < -2147483648.0f) val = -2147483648.0f;
-		*result++ = (int32_t)val;
+	float in[POW_INT_BLOCK], out[POW_INT_BLOCK];
+	for (int c = 0; c < count; c += POW_INT_BLOCK) {
+		const int n = count - c < POW_INT_BLOCK ? count - c : POW_INT_BLOCK;
+		for (int i = 0; i < n; i++) {
+			in[i] = (float)x[c + i];
+		}
+		pow_f32(in, n, exponent, out);
+		for (int i = 0; i < n; i++) {
+			result[c + i] = __quantize_sat_i32(out[i]);
+		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
-
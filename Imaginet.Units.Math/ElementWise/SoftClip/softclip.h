@@ -11,6 +11,14 @@ static inline void softclip_tanh_f32(const float* restrict x, int count, float*
 }
 #pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "softclip_tanh_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../Trigonometry/Tanh/tanh.h:tanh_fast_f32"
+static inline void softclip_tanh_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	tanh_fast_f32(x, count, output);
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "softclip_cubic_f32"
 static inline void softclip_cubic_f32(const float* restrict x, int count, float* restrict output)
 {
@@ -1,4 +1,5 @@
 #pragma IMAGINET_INCLUDES_BEGIN
+#include <stddef.h>
 #include <stdint.h>
 #include <math.h>
 #pragma IMAGINET_INCLUDES_END
@@ -53,4 +54,181 @@ static inline void batch_standardization_f32(const float* restrict x, int count,
 		output[i] = (x[i] - mean) / std_dev;
 	}
 }
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "standardization_running"
+
+// Running mean and variance over a stream of tensors, used like the running min/max of
+// Normalization: each tensor is standardized with the statistics of the tensors before it, while
+// its own mean and sum of squared deviations (M2) are gathered in the same loop.
+//
+// Handle layout (size = 16 + window * 12 bytes):
+//   standardization_running_state header
+//   float ring[window][3]     count, mean and M2 of the last 'window' tensors (window mode only)
+typedef struct {
+	float mean;
+	float var;
+	int32_t tensors;    // number of tensors added so far
+	int32_t window;     // 0 for exponential weighting, else the number of tensors in the ring
+} standardization_running_state;
+
+static inline int standardization_running_init(int8_t* restrict handle, int window)
+{
+	standardization_running_state* state = (standardization_running_state*)handle;
+	state->mean = 0.0f;
+	state->var = 1.0f;
+	state->tensors = 0;
+	state->window = window;
+	return 0;
+}
+
+static inline int standardization_running_frozen(const standardization_running_state* state, int warmup)
+{
+	return warmup > 0 && state->tensors >= warmup;
+}
+
+static inline void standardization_running_add(standardization_running_state* state, int count, float mean, float m2, float alpha)
+{
+	const float n = (float)count;
+
+	if (state->window > 0) {
+		float* ring = (float*)(state + 1);
+		const int slot = state->tensors % state->window;
+		const int used = state->tensors < state->window ? state->tensors + 1 : state->window;
+		ring[3 * slot] = n;
+		ring[3 * slot + 1] = mean;
+		ring[3 * slot + 2] = m2;
+
+		// Chan's pairwise update over the ring
+		float total = ring[0], total_mean = ring[1], total_m2 = ring[2];
+		for (int i = 1; i < used; i++) {
+			const float* e = ring + 3 * i;
+			const float sum = total + e[0];
+			const float delta = e[1] - total_mean;
+			total_mean += delta * (e[0] / sum);
+			total_m2 += e[2] + delta * delta * (total * e[0] / sum);
+			total = sum;
+		}
+		state->mean = total_mean;
+		state->var = total_m2 / total;
+	}
+	else if (state->tensors == 0) {
+		state->mean = mean;
+		state->var = m2 / n;
+	}
+	else {
+		const float delta = mean - state->mean;
+		state->mean += alpha * delta;
+		state->var = (1.0f - alpha) * (state->var + alpha * delta * delta) + alpha * (m2 / n);
+	}
+	state->tensors++;
+}
+
+// Deviations d = x - state->mean summed to s1 and squared to s2. Summing deviations from the
+// running mean avoids the cancellation of sum(x^2) - n * mean^2 on data with a large offset.
+static inline void standardization_running_add_f32(standardization_running_state* state, int count, float s1, float s2, float alpha)
+{
+	const float n = (float)count;
+	const float m2 = s2 - s1 * s1 / n;
+	standardization_running_add(state, count, state->mean + s1 / n, m2 < 0.0f ? 0.0f : m2, alpha);
+}
+
+// Exact integer sums of x and x^2
+static inline void standardization_running_add_int(standardization_running_state* state, int count, int64_t sum, int64_t sum_sq, float alpha)
+{
+	const int64_t m2_n = sum_sq * count - sum * sum;    // M2 * count, exact
+	standardization_running_add(state, count, (float)sum / (float)count, (float)m2_n / (float)count, alpha);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_standardization_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "standardization_running"
+static inline void running_standardization_f32(const float* restrict x, int count, float* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	standardization_running_state* state = (standardization_running_state*)handle;
+	const int first = state->tensors == 0;
+	const int update = !first && !standardization_running_frozen(state, warmup);
+
+	if (first) {
+		float sum = 0.0f;
+		for (int i = 0; i < count; i++) {
+			sum += x[i];
+		}
+		state->mean = sum / (float)count;
+
+		float s1 = 0.0f, s2 = 0.0f;
+		for (int i = 0; i < count; i++) {
+			const float d = x[i] - state->mean;
+			s1 += d;
+			s2 += d * d;
+		}
+		standardization_running_add_f32(state, count, s1, s2, alpha);
+	}
+
+	const float mean = state->mean;
+	const float std_dev = sqrtf(state->var);
+	const float scale = std_dev == 0.0f ? 1.0f : 1.0f / std_dev;
+
+	if (!update) {
+		for (int i = 0; i < count; i++) {
+			output[i] = (x[i] - mean) * scale;
+		}
+		return;
+	}
+
+	float s1 = 0.0f, s2 = 0.0f;
+	for (int i = 0; i < count; i++) {
+		const float d = x[i] - mean;
+		s1 += d;
+		s2 += d * d;
+		output[i] = d * scale;
+	}
+	standardization_running_add_f32(state, count, s1, s2, alpha);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_standardization_8bit"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "standardization_running"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Normalization/normalization.h:running_8bit"
+static inline void __running_standardization_8bit(const uint8_t* restrict x, int is_signed, int count, uint8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	standardization_running_state* state = (standardization_running_state*)handle;
+	const int first = state->tensors == 0;
+	const int update = !first && !standardization_running_frozen(state, warmup);
+	running_8bit_stats stats;
+
+	if (first) {
+		running_8bit_gather(x, is_signed, count, &stats);
+		standardization_running_add_int(state, count, stats.sum, stats.sum_sq, alpha);
+	}
+
+	// Divides in float like standardization_i8: mean and std are rarely multiples of 2^-16
+	const float std_dev = sqrtf(state->var);
+	const normalization_q16 q = normalization_q16_make_float(state->mean, std_dev == 0.0f ? 1.0f : std_dev);
+
+	running_8bit_apply(x, is_signed, count, output, q, update ? &stats : NULL);
+	if (update)
+		standardization_running_add_int(state, count, stats.sum, stats.sum_sq, alpha);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_standardization_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "running_standardization_8bit"
+static inline void running_standardization_i8(const int8_t* restrict x, int count, int8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	__running_standardization_8bit((const uint8_t*)x, 1, count, (uint8_t*)output, handle, alpha, warmup);
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "running_standardization_u8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "running_standardization_8bit"
+static inline void running_standardization_u8(const uint8_t* restrict x, int count, uint8_t* restrict output,
+	int8_t* restrict handle, float alpha, int warmup)
+{
+	__running_standardization_8bit(x, 0, count, output, handle, alpha, warmup);
+}
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
@@ -3,13 +3,21 @@
 #include <stdio.h>
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_to_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Quantize/quantize_d.h:quantize_sat"
+
+// Maps a [0, 1] value to int8: (value * 255 - 128), saturated. Shared by the D and Q formats.
+static inline int8_t __dequantize_to_i8(float value)
+{
+	return __quantize_sat_i8(value * 255.0f - 128.0f);
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d32_to_f32"
 static inline void dequantize_d32_to_f32(const int32_t* restrict src, float* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		*dst++ = (*src++ - offset) * scale;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = (src[i] - offset) * scale;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -17,10 +25,8 @@ static inline void dequantize_d32_to_f32(const int32_t* restrict src, float* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d16_to_f32"
 static inline void dequantize_d16_to_f32(const int16_t* restrict src, float* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		*dst++ = (*src++ - offset) * scale;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = (src[i] - offset) * scale;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -28,70 +34,41 @@ static inline void dequantize_d16_to_f32(const int16_t* restrict src, float* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d8_to_f32"
 static inline void dequantize_d8_to_f32(const int8_t* restrict src, float* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		*dst++ = (*src++ - offset) * scale;
-		count--;
-	} 
+	for (int i = 0; i < count; i++) {
+		dst[i] = (src[i] - offset) * scale;
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d32_to_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_to_i8"
 static inline void dequantize_d32_to_i8(const int32_t* restrict src, int8_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		int32_t raw_src = *src++;
-		float val = (raw_src - offset) * scale;
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
+	// Scale [0,1] range to int8 range [-128,127]
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((src[i] - offset) * scale);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d16_to_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_to_i8"
 static inline void dequantize_d16_to_i8(const int16_t* restrict src, int8_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		int16_t raw_src = *src++;
-		float val = (raw_src - offset) * scale;
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
+	// Scale [0,1] range to int8 range [-128,127]
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((src[i] - offset) * scale);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_d8_to_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_to_i8"
 static inline void dequantize_d8_to_i8(const int8_t* restrict src, int8_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		int8_t raw_src = *src++;
-		float val = (raw_src - offset) * scale;
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
+	// Scale [0,1] range to int8 range [-128,127]
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((src[i] - offset) * scale);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
@@ -6,10 +6,8 @@
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i32_to_f32"
 static inline void dequantize_i32_to_f32(const int32_t* restrict src, float* restrict dst, int count)
 {
-	while (count > 0U)
-	{
-		*dst++ = *src++;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = src[i];
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -17,10 +15,8 @@ static inline void dequantize_i32_to_f32(const int32_t* restrict src, float* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i16_to_f32"
 static inline void dequantize_i16_to_f32(const int16_t* restrict src, float* restrict dst, int count)
 {
-	while (count > 0U)
-	{
-		*dst++ = *src++;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = src[i];
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -28,10 +24,8 @@ static inline void dequantize_i16_to_f32(const int16_t* restrict src, float* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i8_to_f32"
 static inline void dequantize_i8_to_f32(const int8_t* restrict src, float* restrict dst, int count)
 {
-	while (count > 0U)
-	{
-		*dst++ = *src++;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = src[i];
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -39,15 +33,12 @@ static inline void dequantize_i8_to_f32(const int8_t* restrict src, float* restr
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i32_to_i8"
 static inline void dequantize_i32_to_i8(const int32_t* restrict src, int8_t* restrict dst, int count)
 {
-	while (count > 0U)
-	{
+	for (int i = 0; i < count; i++) {
 		// Clamp to int8 range
-		if (val > 127) val = 127;
-		else if (val < -128) val = -128;
-		
-		*dst++ = (int8_t)val;
-
-		count--;
+		int32_t val = src[i];
+		val = val > 127 ? 127 : val;
+		val = val < -128 ? -128 : val;
+		dst[i] = (int8_t)val;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -55,15 +46,12 @@ static inline void dequantize_i32_to_i8(const int32_t* restrict src, int8_t* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i16_to_i8"
 static inline void dequantize_i16_to_i8(const int16_t* restrict src, int8_t* restrict dst, int count)
 {
-	while (count > 0U)
-	{
+	for (int i = 0; i < count; i++) {
 		// Clamp to int8 range
-		if (val > 127) val = 127;
-		else if (val < -128) val = -128;
-		
-		*dst++ = (int8_t)val;
-		
-		count--;
+		int32_t val = src[i];
+		val = val > 127 ? 127 : val;
+		val = val < -128 ? -128 : val;
+		dst[i] = (int8_t)val;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -71,13 +59,8 @@ static inline void dequantize_i16_to_i8(const int16_t* restrict src, int8_t* res
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_i8_to_i8"
 static inline void dequantize_i8_to_i8(const int8_t* restrict src, int8_t* restrict dst, int count)
 {
-	while (count > 0U)
-	{
-		int8_t val = *src++;
-		
-		*dst++ = val;
-		
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = src[i];
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -4,111 +4,197 @@
 #include "arm_math.h"
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q_common"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+
+#define DEQUANTIZE_AXIS_BLOCK 64
+
+// Dividing by 2^(bits - 1 - shift) is exact, and so is multiplying by its reciprocal, so the loops
+// below multiply with a factor computed once instead of dividing every element.
+static inline float __dequantize_q_factor(int fraction_bits, int shift)
+{
+	return ldexpf(1.0f, shift - fraction_bits);
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q31_to_f32"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
 static inline void dequantize_q31_to_f32(const q31_t* restrict src, float* restrict dst, int count, int shift)
 {
-	// arm_q15_to_float(src, dst, count);
-	// arm_scale_f32(dst, (1 << shift), dst, count);
-
-	while (count > 0U)
-	{
-		*dst++ = ((float32_t)*src++ / (float32_t)(2147483648 >> shift));
-		count--;
+	const float factor = __dequantize_q_factor(31, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = (float32_t)src[i] * factor;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q15_to_f32"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
 static inline void dequantize_q15_to_f32(const q15_t* restrict src, float* restrict dst, int count, int shift)
 {
-	// arm_q15_to_float(src, dst, count);
-	// arm_scale_f32(dst, (1 << shift), dst, count);
-
-	while (count > 0U)
-	{
-		*dst++ = ((float32_t)*src++ / (float32_t)(32768 >> shift));
-		count--;
+	const float factor = __dequantize_q_factor(15, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = (float32_t)src[i] * factor;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q7_to_f32"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
 static inline void dequantize_q7_to_f32(const q7_t* restrict src, float* restrict dst, int count, int shift)
 {
-	// arm_q7_to_float(src, dst, count);
-	// arm_scale_f32(dst, (1 << shift), dst, count);
-
-	while (count > 0U)
-	{
-		*dst++ = ((float32_t)*src++ / (float32_t)(128 >> shift));
-		count--;
-	} 
+	const float factor = __dequantize_q_factor(7, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = (float32_t)src[i] * factor;
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q31_to_i8"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_d.h:dequantize_to_i8"
 static inline void dequantize_q31_to_i8(const q31_t* restrict src, int8_t* restrict dst, int count, int shift)
 {
-	while (count > 0U)
-	{
-		q31_t raw_src = *src++;
-		float32_t val = ((float32_t)raw_src / (float32_t)(2147483648 >> shift));
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
+	// Scale [0,1] range to int8 range [-128,127]
+	const float factor = __dequantize_q_factor(31, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((float32_t)src[i] * factor);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q15_to_i8"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_d.h:dequantize_to_i8"
 static inline void dequantize_q15_to_i8(const q15_t* restrict src, int8_t* restrict dst, int count, int shift)
 {
-
-	while (count > 0U)
-	{
-		q15_t raw_src = *src++;
-		float32_t val = ((float32_t)raw_src / (float32_t)(32768 >> shift));
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
+	// Scale [0,1] range to int8 range [-128,127]
+	const float factor = __dequantize_q_factor(15, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((float32_t)src[i] * factor);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dequantize_q7_to_i8"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_d.h:dequantize_to_i8"
 static inline void dequantize_q7_to_i8(const q7_t* restrict src, int8_t* restrict dst, int count, int shift)
 {
-	while (count > 0U)
-	{
-		q7_t raw_src = *src++;
-		float32_t val = ((float32_t)raw_src / (float32_t)(128 >> shift));
-		
-		// Scale [0,1] range to int8 range [-128,127]
-		int32_t ival = (int32_t)(val * 255.0f - 128.0f);
-		if (ival > 127) ival = 127;
-		else if (ival < -128) ival = -128;
-		
-		*dst++ = (int8_t)ival;
-		
-		count--;
-	} 
+	// Scale [0,1] range to int8 range [-128,127]
+	const float factor = __dequantize_q_factor(7, shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __dequantize_to_i8((float32_t)src[i] * factor);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+// Per-channel dequantization, the inverse of quantize_axis_*: every index j along the axis has its
+// own shift, shift + channel_shifts[j].
+// d0 = input.shape.step(axis)
+// d1 = input.shape.size(axis)
+// d2 = input.shape.slot(axis)
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_axis_q_common"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_q_common"
+static inline void __dequantize_axis_factors(int fraction_bits, int shift, const int8_t* restrict channel_shifts, int cols, float* restrict factor)
+{
+	for (int j = 0; j < cols; j++) {
+		factor[j] = __dequantize_q_factor(fraction_bits, shift + channel_shifts[j]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_axis_q31_to_f32"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_axis_q_common"
+static inline void dequantize_axis_q31_to_f32(const q31_t* restrict src, float* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += DEQUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < DEQUANTIZE_AXIS_BLOCK ? d1 - c : DEQUANTIZE_AXIS_BLOCK;
+		float factor[DEQUANTIZE_AXIS_BLOCK];
+		__dequantize_axis_factors(31, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const q31_t* x = src + (k * d1 + c) * d0;
+			float* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = (float32_t)x[j] * factor[j];
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = (float32_t)x[j * d0 + i] * factor[j];
+				}
+			}
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_axis_q15_to_f32"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_axis_q_common"
+static inline void dequantize_axis_q15_to_f32(const q15_t* restrict src, float* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += DEQUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < DEQUANTIZE_AXIS_BLOCK ? d1 - c : DEQUANTIZE_AXIS_BLOCK;
+		float factor[DEQUANTIZE_AXIS_BLOCK];
+		__dequantize_axis_factors(15, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const q15_t* x = src + (k * d1 + c) * d0;
+			float* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = (float32_t)x[j] * factor[j];
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = (float32_t)x[j * d0 + i] * factor[j];
+				}
+			}
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dequantize_axis_q7_to_f32"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dequantize_axis_q_common"
+static inline void dequantize_axis_q7_to_f32(const q7_t* restrict src, float* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += DEQUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < DEQUANTIZE_AXIS_BLOCK ? d1 - c : DEQUANTIZE_AXIS_BLOCK;
+		float factor[DEQUANTIZE_AXIS_BLOCK];
+		__dequantize_axis_factors(7, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const q7_t* x = src + (k * d1 + c) * d0;
+			float* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = (float32_t)x[j] * factor[j];
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = (float32_t)x[j * d0 + i] * factor[j];
+				}
+			}
+		}
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
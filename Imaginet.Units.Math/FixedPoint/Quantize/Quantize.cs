@@ -0,0 +1,60 @@
+﻿using System;
+using System.Globalization;
+using System.Linq;
+using Imagimob;
+using Imaginet.Viper;
+
+namespace Imaginet.Units.Math.Quantize;
+
+public static class Quantize
+{
+    /// <summary>
+    /// Parses the per-channel shifts of the Quantize and Dequantize units.
+    /// </summary>
+    /// <param name="shifts">Comma separated shifts, one per index along the quantization axis.
+    /// An empty string gives a zero shift for every channel.</param>
+    /// <param name="channels">Size of the quantization axis.</param>
+    /// <returns>One shift per channel, added to the tensor shift.</returns>
+    public static sbyte[] ChannelShifts(string shifts, int channels)
+    {
+        if (string.IsNullOrWhiteSpace(shifts))
+            return new sbyte[channels];
+
+        var values = shifts.Split(',', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries)
+            .Select(ParseShift)
+            .ToArray();
+
+        if (values.Length != channels)
+            throw new ImaginetException($"The number of channel shifts doesn't match the size of the axis. Expected {channels}, got {values.Length}");
+
+        return values;
+    }
+
+    /// <summary>
+    /// Key of a per-channel quantization, stored in the offset of the Q-format tensor produced by the
+    /// Quantize unit. The Dequantize unit compares it with its own axis and channel shifts, since the
+    /// tensor itself records the common shift only.
+    /// </summary>
+    /// <param name="axis">Quantization axis.</param>
+    /// <param name="shifts">Comma separated shifts, as given to <see cref="ChannelShifts"/>.</param>
+    /// <param name="channels">Size of the quantization axis.</param>
+    /// <returns>A positive key; per-tensor Q-format tensors have offset 0.</returns>
+    public static long ChannelKey(int axis, string shifts, int channels)
+    {
+        // FNV-1a over the axis and the parsed shifts, so spacing in the option text doesn't matter
+        uint hash = 2166136261;
+        hash = (hash ^ (uint)axis) * 16777619;
+        foreach (var shift in ChannelShifts(shifts, channels))
+            hash = (hash ^ (byte)shift) * 16777619;
+
+        return 1 + (hash & 0x7FFFFFFE);
+    }
+
+    private static sbyte ParseShift(string shift)
+    {
+        if (!sbyte.TryParse(shift, NumberStyles.Integer, CultureInfo.InvariantCulture, out var value))
+            throw new ImaginetException($"Channel shift '{shift}' is not an integer in the range {sbyte.MinValue}...{sbyte.MaxValue}");
+
+        return value;
+    }
+}
@@ -2,53 +2,62 @@
 #include <math.h>
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "quantize_sat"
+
+// Saturating truncation of a float to an integer type. The value is clamped in float before the
+// truncating conversion, which gives the same result as comparing first and converting in range
+// only, but without branches, so the calling loops vectorize.
+static inline int8_t __quantize_sat_i8(float value)
+{
+	value = value > 127.0f ? 127.0f : value;
+	value = value < -128.0f ? -128.0f : value;
+	return (int8_t)(int32_t)value;
+}
+
+static inline int16_t __quantize_sat_i16(float value)
+{
+	value = value > 32767.0f ? 32767.0f : value;
+	value = value < -32768.0f ? -32768.0f : value;
+	return (int16_t)(int32_t)value;
+}
+
+static inline int32_t __quantize_sat_i32(float value)
+{
+	// 2^31 does not fit in int32 and the largest float below it is 2147483520, so values from 2^31
+	// up are clamped to that and the missing low bits are or:ed in.
+	const int32_t high = value >= 2147483648.0f ? 0x7FFFFFFF : 0;
+	value = value > 2147483520.0f ? 2147483520.0f : value;
+	value = value < -2147483648.0f ? -2147483648.0f : value;
+	return (int32_t)value | high;
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_d8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_sat"
 static inline void quantize_f32_to_d8(const float* restrict src, int8_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		float value = (*src++ / scale) + offset;
-		if (value > 127)
-			*dst++ = 127;
-		else if (value < -128)
-			*dst++ = -128;
-		else
-			*dst++ = (int8_t)value;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_i8((src[i] / scale) + offset);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_d16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_sat"
 static inline void quantize_f32_to_d16(const float* restrict src, int16_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		float value = (*src++ / scale) + offset;
-		if (value > 32767)
-			*dst++ = 32767;
-		else if (value < -32768)
-			*dst++ = -32768;
-		else
-			*dst++ = (int16_t)value;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_i16((src[i] / scale) + offset);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_d32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_sat"
 static inline void quantize_f32_to_d32(const float* restrict src, int32_t* restrict dst, int count, float scale, int offset)
 {
-	while (count > 0U)
-	{
-		float value = (*src++ / scale) + offset;
-		if (value > 2147483647)
-			*dst++ = 2147483647;
-		else if (value < -2147483648)
-			*dst++ = -2147483648;
-		else
-			*dst++ = (int32_t)value;
-		count--;
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_i32((src[i] / scale) + offset);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
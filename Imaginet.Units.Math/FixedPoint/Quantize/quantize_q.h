@@ -3,44 +3,165 @@
 #include "arm_math.h"
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "quantize_q_sat"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_d.h:quantize_sat"
+
+#define QUANTIZE_AXIS_BLOCK 64
+
+// Saturating conversion of a value already scaled to the Q format. Same result as __SSAT /
+// clip_q63_to_q31 of the converted value but without a branch or a 64 bit intermediate.
+static inline q7_t __quantize_sat_q7(float value)
+{
+	return (q7_t)__quantize_sat_i8(value);
+}
+
+static inline q15_t __quantize_sat_q15(float value)
+{
+	return (q15_t)__quantize_sat_i16(value);
+}
+
+static inline q31_t __quantize_sat_q31(float value)
+{
+	return (q31_t)__quantize_sat_i32(value);
+}
+
+// factor[j] = one * 2^-(shift + channel_shifts[j]) for a block of channels
+static inline void __quantize_axis_factors(float one, int shift, const int8_t* restrict channel_shifts, int cols, float* restrict factor)
+{
+	for (int j = 0; j < cols; j++) {
+		factor[j] = ldexpf(one, -(shift + channel_shifts[j]));
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_q7"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
 static inline void quantize_f32_to_q7(const float* restrict src, q7_t* restrict dst, int count, int shift)
 {
-	// arm_scale_f32(dst, 1d / (1 << shift), temp, count);
-	// arm_float_to_q7(temp, dst, count);
-	while (count > 0U)
-	{
-		*dst++ = (q7_t) __SSAT((q31_t) (*src++ * 128.0f / (1 << shift)), 8);
-		count--;
+	const float factor = ldexpf(128.0f, -shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_q7(src[i] * factor);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_q15"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
 static inline void quantize_f32_to_q15(const float* restrict src, q15_t* restrict dst, int count, int shift)
 {
-	// arm_scale_f32(dst, 1d / (1 << shift), temp, count);
-	// arm_float_to_q15(temp, dst, count);
-	while (count > 0U)
-	{
-		*dst++ = (q15_t) __SSAT((q31_t) (*src++ * 32768.0f / (1 << shift)), 16);
-		count--;
+	const float factor = ldexpf(32768.0f, -shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_q15(src[i] * factor);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "quantize_f32_to_q31"
 #pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
 static inline void quantize_f32_to_q31(const float* restrict src, q31_t* restrict dst, int count, int shift)
 {
-	// arm_scale_f32(dst, 1d / (1 << shift), temp, count);
-	// arm_float_to_q31(temp, dst, count);
-	while (count > 0U)
-	{
-		*dst++ = clip_q63_to_q31((q63_t)(*src++ * 2147483648.0f / (1 << shift)));
-		count--;
+	const float factor = ldexpf(2147483648.0f, -shift);
+	for (int i = 0; i < count; i++) {
+		dst[i] = __quantize_sat_q31(src[i] * factor);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+// Per-channel quantization: every index j along the axis has its own shift, shift + channel_shifts[j].
+// d0 = input.shape.step(axis)
+// d1 = input.shape.size(axis)
+// d2 = input.shape.slot(axis)
+// The factors of a block of channels are computed once and reused for all slots. When the axis is
+// the innermost one (d0 == 1) the inner loop runs over the channels, otherwise over d0 elements
+// with a common factor.
+
+#pragma IMAGINET_FRAGMENT_BEGIN "quantize_axis_f32_to_q7"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
+static inline void quantize_axis_f32_to_q7(const float* restrict src, q7_t* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += QUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < QUANTIZE_AXIS_BLOCK ? d1 - c : QUANTIZE_AXIS_BLOCK;
+		float factor[QUANTIZE_AXIS_BLOCK];
+		__quantize_axis_factors(128.0f, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const float* x = src + (k * d1 + c) * d0;
+			q7_t* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = __quantize_sat_q7(x[j] * factor[j]);
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = __quantize_sat_q7(x[j * d0 + i] * factor[j]);
+				}
+			}
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "quantize_axis_f32_to_q15"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
+static inline void quantize_axis_f32_to_q15(const float* restrict src, q15_t* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += QUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < QUANTIZE_AXIS_BLOCK ? d1 - c : QUANTIZE_AXIS_BLOCK;
+		float factor[QUANTIZE_AXIS_BLOCK];
+		__quantize_axis_factors(32768.0f, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const float* x = src + (k * d1 + c) * d0;
+			q15_t* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = __quantize_sat_q15(x[j] * factor[j]);
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = __quantize_sat_q15(x[j * d0 + i] * factor[j]);
+				}
+			}
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "quantize_axis_f32_to_q31"
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "quantize_q_sat"
+static inline void quantize_axis_f32_to_q31(const float* restrict src, q31_t* restrict dst, int d0, int d1, int d2, int shift, const int8_t* restrict channel_shifts)
+{
+	for (int c = 0; c < d1; c += QUANTIZE_AXIS_BLOCK) {
+		const int cols = d1 - c < QUANTIZE_AXIS_BLOCK ? d1 - c : QUANTIZE_AXIS_BLOCK;
+		float factor[QUANTIZE_AXIS_BLOCK];
+		__quantize_axis_factors(2147483648.0f, shift, channel_shifts + c, cols, factor);
+
+		for (int k = 0; k < d2; k++) {
+			const float* x = src + (k * d1 + c) * d0;
+			q31_t* y = dst + (k * d1 + c) * d0;
+			if (d0 == 1) {
+				for (int j = 0; j < cols; j++) {
+					y[j] = __quantize_sat_q31(x[j] * factor[j]);
+				}
+				continue;
+			}
+			for (int j = 0; j < cols; j++) {
+				for (int i = 0; i < d0; i++) {
+					y[j * d0 + i] = __quantize_sat_q31(x[j * d0 + i] * factor[j]);
+				}
+			}
+		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
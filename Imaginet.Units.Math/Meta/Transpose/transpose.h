@@ -1,19 +1,166 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <stdint.h>
+#include <string.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "transpose_f32"
+#pragma IMAGINET_FRAGMENT_BEGIN "permute"
 
-static inline void transpose_f32(const float* restrict input, float* restrict output, int rows, int cols)
+#define PERMUTE_MAX_DIMS 5
+
+// Side of the square blocks moved by the tiled kernel. Inside a full block both the reads and
+// the writes stay within PERMUTE_BLOCK cache lines, and the constant bounds let the compiler
+// unroll the block into register shuffles.
+#define PERMUTE_BLOCK 8
+
+// Simplify a permutation given as output dimensions (outermost first) with their input strides:
+// size-1 dimensions are dropped and neighbours that are also neighbours in the input are merged.
+// Returns the remaining number of dimensions.
+static inline int permute_plan(int* restrict size, int* restrict stride, int count)
+{
+    int n = 0;
+    for (int e = 0; e < count; e++) {
+        if (size[e] == 1)
+            continue;
+        if (n > 0 && stride[n - 1] == stride[e] * size[e]) {
+            size[n - 1] *= size[e];
+            stride[n - 1] = stride[e];
+        }
+        else {
+            size[n] = size[e];
+            stride[n] = stride[e];
+            n++;
+        }
+    }
+    return n;
+}
+
+// Copy one rows x cols block: element (r, c) is read from in[r + c * in_step] and written
+// to out[r * out_step + c].
+static inline void permute_block(const void* restrict in, void* restrict out, int in_step, int out_step, int rows, int cols, int elem_size)
+{
+    switch (elem_size) {
+    case 1: {
+        const uint8_t* ip = (const uint8_t*)in;
+        uint8_t* op = (uint8_t*)out;
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                op[r * out_step + c] = ip[r + c * in_step];
+        break;
+    }
+    case 2: {
+        const uint16_t* ip = (const uint16_t*)in;
+        uint16_t* op = (uint16_t*)out;
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                op[r * out_step + c] = ip[r + c * in_step];
+        break;
+    }
+    default: {
+        const uint32_t* ip = (const uint32_t*)in;
+        uint32_t* op = (uint32_t*)out;
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                op[r * out_step + c] = ip[r + c * in_step];
+        break;
+    }
+    }
+}
+
+static inline void permute_block_full(const void* restrict in, void* restrict out, int in_step, int out_step, int elem_size)
 {
-    int count = rows * cols;
-    for (int i = 0; i < count; ++i)
-    {
-        int original_row = i / cols;
-        int original_col = i % cols;
-        int transposed_index = original_col * rows + original_row;
-        output[transposed_index] = input[i];
+    permute_block(in, out, in_step, out_step, PERMUTE_BLOCK, PERMUTE_BLOCK, elem_size);
+}
+
+// Write the output in order, where output dimension e (outermost first) has size[e] elements and
+// advances the input by stride[e] elements. Unused leading dimensions have size 1.
+// Elements of 1, 2 or 4 bytes are supported, which covers every 8, 16 and 32 bit type.
+//
+// After permute_plan, if the innermost output dimension is also contiguous in the input, whole rows
+// are copied. Otherwise the input's contiguous dimension is tiled against the output's contiguous
+// dimension in PERMUTE_BLOCK x PERMUTE_BLOCK blocks. All other dimensions are walked with
+// counters, so there is no division or modulo per element.
+static inline void permute(const void* restrict input, void* restrict output, int elem_size,
+    int size0, int size1, int size2, int size3, int size4,
+    int stride0, int stride1, int stride2, int stride3, int stride4)
+{
+    int size[PERMUTE_MAX_DIMS] = { size0, size1, size2, size3, size4 };
+    int stride[PERMUTE_MAX_DIMS] = { stride0, stride1, stride2, stride3, stride4 };
+    const int n = permute_plan(size, stride, PERMUTE_MAX_DIMS);
+
+    const char* in = (const char*)input;
+    char* out = (char*)output;
+
+    if (n == 0) {
+        memcpy(out, in, elem_size);
+        return;
+    }
+
+    // Output strides (contiguous output), in elements.
+    int out_stride[PERMUTE_MAX_DIMS];
+    out_stride[n - 1] = 1;
+    for (int e = n - 2; e >= 0; e--) {
+        out_stride[e] = out_stride[e + 1] * size[e + 1];
+    }
+
+    // Dimension that is contiguous in the input.
+    int t = -1;
+    for (int e = 0; e < n; e++) {
+        if (stride[e] == 1)
+            t = e;
+    }
+
+    const int last = n - 1;
+    const int row_bytes = size[last] * elem_size;
+    const int tiled = t >= 0 && t != last;
+
+    // Odometer over every dimension except the innermost one (and t when tiling).
+    int index[PERMUTE_MAX_DIMS] = { 0 };
+    int in_pos = 0;
+    int out_pos = 0;
+    for (;;) {
+        if (!tiled) {
+            if (stride[last] == 1) {
+                memcpy(out + (size_t)out_pos * elem_size, in + (size_t)in_pos * elem_size, row_bytes);
+            }
+            else {
+                // No dimension is contiguous in the input (only happens with an unusual stride layout).
+                permute_block(in + (size_t)in_pos * elem_size, out + (size_t)out_pos * elem_size, stride[last], 1, 1, size[last], elem_size);
+            }
+        }
+        else {
+            const int rows = size[t];
+            const int cols = size[last];
+            const int in_step = stride[last];
+            const int out_step = out_stride[t];
+            for (int r0 = 0; r0 < rows; r0 += PERMUTE_BLOCK) {
+                const int nr = rows - r0 < PERMUTE_BLOCK ? rows - r0 : PERMUTE_BLOCK;
+                for (int c0 = 0; c0 < cols; c0 += PERMUTE_BLOCK) {
+                    const int nc = cols - c0 < PERMUTE_BLOCK ? cols - c0 : PERMUTE_BLOCK;
+                    const char* ip = in + ((size_t)in_pos + r0 + (size_t)c0 * in_step) * elem_size;
+                    char* op = out + ((size_t)out_pos + (size_t)r0 * out_step + c0) * elem_size;
+                    if (nr == PERMUTE_BLOCK && nc == PERMUTE_BLOCK)
+                        permute_block_full(ip, op, in_step, out_step, elem_size);
+                    else
+                        permute_block(ip, op, in_step, out_step, nr, nc, elem_size);
+                }
+            }
+        }
+
+        int e = last - 1;
+        for (; e >= 0; e--) {
+            if (tiled && e == t)
+                continue;
+            in_pos += stride[e];
+            out_pos += out_stride[e];
+            if (++index[e] < size[e])
+                break;
+            in_pos -= stride[e] * size[e];
+            out_pos -= out_stride[e] * size[e];
+            index[e] = 0;
+        }
+        if (e < 0)
+            break;
     }
 }
 
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
@@ -5,7 +5,12 @@ import numpy as np
 #pragma IMAGINET_FRAGMENT_BEGIN "add"
 
 def add(a, b, output):
-    np.add(a,b, out=output)
+    if np.issubdtype(output.dtype, np.integer):
+        # Integer results saturate to the range of the output type
+        info = np.iinfo(output.dtype)
+        np.copyto(output, np.clip(np.add(a, b, dtype=np.int64), info.min, info.max), casting="unsafe")
+    else:
+        np.add(a, b, out=output)
 
 #pragma IMAGINET_FRAGMENT_END
 
@@ -0,0 +1,110 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "binary_broadcast"
+
+#define BROADCAST_MAX_DIMS 5
+
+// Iteration over the output of a binary element-wise operation with NumPy broadcasting, one
+// innermost row at a time. The operand shapes are given innermost dimension first, padded with 1
+// to BROADCAST_MAX_DIMS; an operand dimension of size 1 is repeated along the output dimension.
+//
+// Dimensions of size 1 are dropped and neighbours that are laid out contiguously in both operands
+// are merged, so the innermost row is as long as possible. Along the row each operand either
+// advances by one element or repeats a single element, which gives the row kernels a contiguous
+// (vectorizable) loop in every case.
+//
+// The output is written in order, one element per output position, and every element is read
+// before it is written. Output may therefore share its buffer with an operand of the same shape.
+typedef struct {
+	int rows;                          // number of innermost rows
+	int inner;                         // output elements per row
+	int a_inner;                       // 1 when a advances along the row, 0 when it repeats
+	int b_inner;                       // 1 when b advances along the row, 0 when it repeats
+	int outer;                         // number of dimensions outside the row
+	int size[BROADCAST_MAX_DIMS];      // sizes of the outer dimensions, innermost first
+	int a_step[BROADCAST_MAX_DIMS];    // a stride of each outer dimension (0 when repeated)
+	int b_step[BROADCAST_MAX_DIMS];    // b stride of each outer dimension (0 when repeated)
+	int index[BROADCAST_MAX_DIMS];     // position in each outer dimension
+	int a_offset;                      // offset of the current row in a
+	int b_offset;                      // offset of the current row in b
+} binary_broadcast;
+
+static inline void binary_broadcast_init(binary_broadcast* bc, const int* a_shape, const int* b_shape)
+{
+	int size[BROADCAST_MAX_DIMS], a_step[BROADCAST_MAX_DIMS], b_step[BROADCAST_MAX_DIMS];
+	int a_stride = 1, b_stride = 1, n = 0;
+
+	bc->rows = 1;
+	for (int e = 0; e < BROADCAST_MAX_DIMS; e++) {
+		const int s = a_shape[e] > b_shape[e] ? a_shape[e] : b_shape[e];
+		const int as = a_shape[e] == 1 ? 0 : a_stride;
+		const int bs = b_shape[e] == 1 ? 0 : b_stride;
+		a_stride *= a_shape[e];
+		b_stride *= b_shape[e];
+		if (s == 1)
+			continue;
+		if (n > 0 && as == a_step[n - 1] * size[n - 1] && bs == b_step[n - 1] * size[n - 1]) {
+			size[n - 1] *= s;
+		}
+		else {
+			size[n] = s;
+			a_step[n] = as;
+			b_step[n] = bs;
+			n++;
+		}
+	}
+
+	bc->inner = n > 0 ? size[0] : 1;
+	bc->a_inner = n > 0 && a_step[0] != 0;
+	bc->b_inner = n > 0 && b_step[0] != 0;
+	bc->outer = n > 0 ? n - 1 : 0;
+	for (int e = 0; e < bc->outer; e++) {
+		bc->size[e] = size[e + 1];
+		bc->a_step[e] = a_step[e + 1];
+		bc->b_step[e] = b_step[e + 1];
+		bc->index[e] = 0;
+		bc->rows *= size[e + 1];
+	}
+	bc->a_offset = 0;
+	bc->b_offset = 0;
+}
+
+// Moves a_offset and b_offset to the next row.
+static inline void binary_broadcast_next(binary_broadcast* bc)
+{
+	for (int e = 0; e < bc->outer; e++) {
+		bc->a_offset += bc->a_step[e];
+		bc->b_offset += bc->b_step[e];
+		if (++bc->index[e] < bc->size[e])
+			return;
+		bc->a_offset -= bc->a_step[e] * bc->size[e];
+		bc->b_offset -= bc->b_step[e] * bc->size[e];
+		bc->index[e] = 0;
+	}
+}
+
+// Integer results are computed in a wider type and saturated to the output type.
+static inline int8_t __broadcast_sat_i8(int32_t value)
+{
+	value = value > INT8_MAX ? INT8_MAX : value;
+	value = value < INT8_MIN ? INT8_MIN : value;
+	return (int8_t)value;
+}
+
+static inline int16_t __broadcast_sat_i16(int32_t value)
+{
+	value = value > INT16_MAX ? INT16_MAX : value;
+	value = value < INT16_MIN ? INT16_MIN : value;
+	return (int16_t)value;
+}
+
+static inline int32_t __broadcast_sat_i32(int64_t value)
+{
+	value = value > INT32_MAX ? INT32_MAX : value;
+	value = value < INT32_MIN ? INT32_MIN : value;
+	return (int32_t)value;
+}
+
+#pragma IMAGINET_FRAGMENT_END
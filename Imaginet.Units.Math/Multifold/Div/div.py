@@ -4,7 +4,14 @@ import numpy as np
 
 #pragma IMAGINET_FRAGMENT_BEGIN "div"
 
-def div(a, b, result):
-    np.divide(a,b, out=output)
+def div(a, b, output):
+    if np.issubdtype(output.dtype, np.integer):
+        # Truncating division, saturated; division by zero gives the extreme value with the sign of a
+        info = np.iinfo(output.dtype)
+        a64, b64 = np.broadcast_arrays(np.asarray(a, dtype=np.int64), np.asarray(b, dtype=np.int64))
+        q = np.where(b64 != 0, np.trunc(a64 / np.where(b64 == 0, 1, b64)), np.sign(a64) * np.iinfo(np.int64).max)
+        np.copyto(output, np.clip(q, info.min, info.max), casting="unsafe")
+    else:
+        np.divide(a, b, out=output)
 
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
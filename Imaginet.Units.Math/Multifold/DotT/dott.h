@@ -14,3 +14,116 @@ static inline void dott_f32(const float *restrict a, const float *restrict b, fl
 }
 
 #pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dott_blocked_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dott_f32"
+
+// Register tile: DOTT_MR rows of b by DOTT_NR rows of a, i.e. a DOTT_MR x DOTT_NR block of out.
+// The DOTT_MR * DOTT_NR accumulators fit in 16 vector registers (4-lane NEON) or 8 (8-lane AVX).
+#define DOTT_MR 4
+#define DOTT_NR 16
+
+// Depth of one packed panel. The panel (DOTT_KC * DOTT_NR floats, 16 kB) stays in L1 while
+// every row block of b streams over it.
+#define DOTT_KC 256
+
+// Copy rows [j0, j0 + nr) of a, columns [k0, k0 + kc), into panel[kc][DOTT_NR] so that the
+// micro-kernel reads DOTT_NR consecutive floats per k. Missing rows are padded with zeros.
+static inline void dott_pack_f32(const float* restrict a, float* restrict panel, int d0, int j0, int nr, int k0, int kc)
+{
+	for (int c = 0; c < DOTT_NR; c++) {
+		if (c < nr) {
+			const float* ap = a + (j0 + c) * d0 + k0;
+			for (int k = 0; k < kc; k++) {
+				panel[k * DOTT_NR + c] = ap[k];
+			}
+		}
+		else {
+			for (int k = 0; k < kc; k++) {
+				panel[k * DOTT_NR + c] = 0.0f;
+			}
+		}
+	}
+}
+
+// out[r][c] (+)= sum_k b[r][k] * panel[k][c] for an mr x nr tile. Each k broadcasts one b value
+// per row against a contiguous panel row, so the inner loop vectorizes over c.
+static inline void dott_kernel_f32(const float* restrict b, const float* restrict panel, float* restrict out,
+	int d0, int d1, int mr, int nr, int kc, int accumulate)
+{
+	float acc[DOTT_MR][DOTT_NR];
+	for (int r = 0; r < DOTT_MR; r++) {
+		for (int c = 0; c < DOTT_NR; c++) {
+			acc[r][c] = 0.0f;
+		}
+	}
+
+	const float* b0 = b;
+	const float* b1 = mr > 1 ? b + d0 : b;
+	const float* b2 = mr > 2 ? b + 2 * d0 : b;
+	const float* b3 = mr > 3 ? b + 3 * d0 : b;
+	for (int k = 0; k < kc; k++) {
+		const float* p = panel + k * DOTT_NR;
+		const float x0 = b0[k], x1 = b1[k], x2 = b2[k], x3 = b3[k];
+		for (int c = 0; c < DOTT_NR; c++) {
+			acc[0][c] += x0 * p[c];
+			acc[1][c] += x1 * p[c];
+			acc[2][c] += x2 * p[c];
+			acc[3][c] += x3 * p[c];
+		}
+	}
+
+	for (int r = 0; r < mr; r++) {
+		float* op = out + r * d1;
+		if (accumulate) {
+			for (int c = 0; c < nr; c++) {
+				op[c] += acc[r][c];
+			}
+		}
+		else {
+			for (int c = 0; c < nr; c++) {
+				op[c] = acc[r][c];
+			}
+		}
+	}
+}
+
+// Blocked GEMM over the output columns [j_begin, j_end), i.e. rows j_begin .. j_end - 1 of a.
+// Any range works; ranges that start at a multiple of DOTT_NR split the columns into the same
+// panels as a single call. Disjoint column ranges write disjoint parts of out and only read a
+// and b, so a host application can hand ranges to its own workers, each with its own panel.
+static inline void dott_blocked_cols_f32(const float* restrict a, const float* restrict b, float* restrict out,
+	int d0, int d1, int d2, float* restrict panel, int j_begin, int j_end)
+{
+	for (int j0 = j_begin; j0 < j_end; j0 += DOTT_NR) {
+		const int nr = j_end - j0 < DOTT_NR ? j_end - j0 : DOTT_NR;
+		for (int k0 = 0; k0 < d0; k0 += DOTT_KC) {
+			const int kc = d0 - k0 < DOTT_KC ? d0 - k0 : DOTT_KC;
+			dott_pack_f32(a, panel, d0, j0, nr, k0, kc);
+			for (int i0 = 0; i0 < d2; i0 += DOTT_MR) {
+				const int mr = d2 - i0 < DOTT_MR ? d2 - i0 : DOTT_MR;
+				dott_kernel_f32(b + i0 * d0 + k0, panel, out + i0 * d1 + j0, d0, d1, mr, nr, kc, k0 > 0);
+			}
+		}
+	}
+}
+
+// Same result as dott_f32, computed as a blocked GEMM: a is packed panel by panel into 'panel'
+// (DOTT_KC * DOTT_NR floats) and reused from L1 by all d2 rows of b, instead of re-streaming
+// a for every row of b. With fewer than DOTT_MR rows in b (matrix-vector) or a very narrow a,
+// packing cannot pay off and the plain kernel is used.
+// A batch of b matrices [batch][rows][d0] is passed as d2 = batch * rows: the output rows follow
+// the same order, and every packed panel of a is shared by the whole batch.
+static inline void dott_blocked_f32(const float* restrict a, const float* restrict b, float* restrict out,
+	int d0, int d1, int d2, float* restrict panel)
+{
+	if (d2 < DOTT_MR || d1 < DOTT_NR / 2) {
+		dott_f32(a, b, out, d0, d1, d2);
+		return;
+	}
+
+	dott_blocked_cols_f32(a, b, out, d0, d1, d2, panel, 0, d1);
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -5,6 +5,24 @@ import numpy as np
 #pragma IMAGINET_FRAGMENT_BEGIN "dott"
 
 def dott(a, b, output):
-    np.copyto(output, np.dot(a, b.T).T)
+    # b @ a.T == dot(a, b.T).T, and also broadcasts over a leading batch axis of b. A 1-D a is
+    # treated as a single row, and the result takes the output shape (e.g. [batch, rows, 1]).
+    np.copyto(output, np.reshape(np.matmul(b, np.atleast_2d(a).T), output.shape))
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dott_i8"
+
+def dott_i8(a, b, output, a_scale, a_offset, b_scale, b_offset, output_scale, output_offset):
+    if np.ndim(a_scale) > 0:
+        # Per-channel quantization: one scale and zero point per row of a
+        a_scale = np.reshape(a_scale, (-1, 1))
+        a_offset = np.reshape(a_offset, (-1, 1))
+    acc = np.matmul(b.astype(np.int32) - b_offset, np.atleast_2d(a.astype(np.int32) - a_offset).T)
+    result = acc * (np.transpose(a_scale) * b_scale)
+    if output.dtype == np.int8:
+        # Same rounding and saturation as Quantize (float -> d8)
+        result = np.trunc(np.clip(result / output_scale + output_offset, -128, 127))
+    np.copyto(output, np.reshape(result, output.shape).astype(output.dtype))
 
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <stddef.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dott_i8_core"
+
+// Plain int8 x int8 -> int32 dot product. Integer addition is associative, so compilers turn this
+// into widening multiply-add instructions (pmaddwd / VNNI on x86, sdot on Arm with the dot product
+// extension) without any intrinsics.
+static inline int32_t dot_mac_i8(const int8_t* restrict a, const int8_t* restrict b, int count)
+{
+	int32_t sum = 0;
+	for (int k = 0; k < count; k++) {
+		sum += (int32_t)a[k] * (int32_t)b[k];
+	}
+	return sum;
+}
+
+static inline int32_t sum_i8(const int8_t* restrict a, int count)
+{
+	int32_t sum = 0;
+	for (int k = 0; k < count; k++) {
+		sum += a[k];
+	}
+	return sum;
+}
+
+// Writes one result: requantized to out_d8 when given, otherwise the real value to out_f32.
+static inline void __dott_i8_store(float real, float out_scale, int out_offset, int8_t* restrict out_d8, float* restrict out_f32, int index)
+{
+	if (out_d8 == NULL) {
+		out_f32[index] = real;
+		return;
+	}
+	float q = real / out_scale + out_offset;
+	q = q > 127.0f ? 127.0f : q;
+	q = q < -128.0f ? -128.0f : q;
+	out_d8[index] = (int8_t)(int32_t)q;
+}
+
+// D8 values are real = (q - offset) * scale (see Dequantize). With za, zb the zero points:
+//   sum_k (a_k - za)(b_k - zb) = sum_k a_k b_k - zb * sum_k a_k - za * sum_k b_k + d0 * za * zb
+// so the inner loop only multiplies raw int8 values. The row sums of a are computed once per call
+// into row_sums[d1], the row sum of b once per row of b.
+//
+// scale/offset hold the scale and zero point of a, one per row of a when channel_step is 1
+// (per-channel) or a single value when it is 0 (per-tensor).
+// Exactly one of out_d8 / out_f32 is written: out_d8 is requantized like Quantize
+// (q = real / out_scale + out_offset, saturated to int8), out_f32 holds the real values.
+static inline void dott_i8_core(const int8_t* restrict a, const int8_t* restrict b, int d0, int d1, int d2,
+	int32_t* restrict row_sums, const float* restrict scale, const int32_t* restrict offset, int channel_step,
+	float b_scale, int b_offset, float out_scale, int out_offset, int8_t* restrict out_d8, float* restrict out_f32)
+{
+	for (int j = 0; j < d1; j++) {
+		row_sums[j] = sum_i8(a + j * d0, d0);
+	}
+
+	for (int i = 0; i < d2; i++) {
+		const int8_t* bp = b + i * d0;
+		const int32_t sum_b = sum_i8(bp, d0);
+		const float* sp = scale;
+		const int32_t* zp = offset;
+
+		int j = 0;
+		for (; j + 4 <= d1; j += 4) {
+			// Four rows of a against one row of b, so each row of b is loaded once per 4 outputs.
+			int32_t acc[4];
+			const int8_t* ap = a + j * d0;
+			int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+			for (int k = 0; k < d0; k++) {
+				const int32_t x = bp[k];
+				s0 += (int32_t)ap[k] * x;
+				s1 += (int32_t)ap[d0 + k] * x;
+				s2 += (int32_t)ap[2 * d0 + k] * x;
+				s3 += (int32_t)ap[3 * d0 + k] * x;
+			}
+			acc[0] = s0;
+			acc[1] = s1;
+			acc[2] = s2;
+			acc[3] = s3;
+
+			for (int r = 0; r < 4; r++) {
+				const int32_t za = *zp;
+				const int32_t v = acc[r] - b_offset * row_sums[j + r] - za * sum_b + d0 * za * b_offset;
+				__dott_i8_store((float)v * (*sp * b_scale), out_scale, out_offset, out_d8, out_f32, i * d1 + j + r);
+				sp += channel_step;
+				zp += channel_step;
+			}
+		}
+
+		for (; j < d1; j++) {
+			const int32_t za = *zp;
+			const int32_t v = dot_mac_i8(a + j * d0, bp, d0) - b_offset * row_sums[j] - za * sum_b + d0 * za * b_offset;
+			__dott_i8_store((float)v * (*sp * b_scale), out_scale, out_offset, out_d8, out_f32, i * d1 + j);
+			sp += channel_step;
+			zp += channel_step;
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dott_i8_d8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dott_i8_core"
+
+// Per-tensor quantized a, requantized D8 output.
+static inline void dott_i8_d8(const int8_t* restrict a, const int8_t* restrict b, int8_t* restrict out, int d0, int d1, int d2,
+	int32_t* restrict row_sums, float a_scale, int a_offset, float b_scale, int b_offset, float out_scale, int out_offset)
+{
+	const int32_t za = a_offset;
+	dott_i8_core(a, b, d0, d1, d2, row_sums, &a_scale, &za, 0, b_scale, b_offset, out_scale, out_offset, out, NULL);
+}
+
+// Per-channel quantized a (one scale and zero point per row of a), requantized D8 output.
+static inline void dott_i8_channel_d8(const int8_t* restrict a, const int8_t* restrict b, int8_t* restrict out, int d0, int d1, int d2,
+	int32_t* restrict row_sums, const float* restrict channel_scale, const int32_t* restrict channel_offset,
+	float b_scale, int b_offset, float out_scale, int out_offset)
+{
+	dott_i8_core(a, b, d0, d1, d2, row_sums, channel_scale, channel_offset, 1, b_scale, b_offset, out_scale, out_offset, out, NULL);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dott_i8_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "dott_i8_core"
+
+// Per-tensor quantized a, float32 output.
+static inline void dott_i8_f32(const int8_t* restrict a, const int8_t* restrict b, float* restrict out, int d0, int d1, int d2,
+	int32_t* restrict row_sums, float a_scale, int a_offset, float b_scale, int b_offset)
+{
+	const int32_t za = a_offset;
+	dott_i8_core(a, b, d0, d1, d2, row_sums, &a_scale, &za, 0, b_scale, b_offset, 1.0f, 0, NULL, out);
+}
+
+// Per-channel quantized a (one scale and zero point per row of a), float32 output.
+static inline void dott_i8_channel_f32(const int8_t* restrict a, const int8_t* restrict b, float* restrict out, int d0, int d1, int d2,
+	int32_t* restrict row_sums, const float* restrict channel_scale, const int32_t* restrict channel_offset,
+	float b_scale, int b_offset)
+{
+	dott_i8_core(a, b, d0, d1, d2, row_sums, channel_scale, channel_offset, 1, b_scale, b_offset, 1.0f, 0, NULL, out);
+}
+
+#pragma IMAGINET_FRAGMENT_END
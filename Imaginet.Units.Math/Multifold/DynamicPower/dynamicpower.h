@@ -4,13 +4,23 @@
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "dynamic_power_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../ElementWise/Pow/pow.h:pow_f32"
 
+// The exponent is read once per call and pow_f32 runs the kernel specialized for it
+// (square, sqrt, reciprocal, ...), falling back to powf for other exponents.
 static inline void dynamic_power_f32(const float* restrict input, const float* restrict exponent, float* restrict output, int count)
 {
-    float exp = *exponent;
-    for (int i = 0; i < count; i++) {
-        *output++ = powf(*input++, exp);
-    }
+    pow_f32(input, count, *exponent, output);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "dynamic_power_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../ElementWise/Pow/pow.h:pow_fast_f32"
+
+static inline void dynamic_power_fast_f32(const float* restrict input, const float* restrict exponent, float* restrict output, int count)
+{
+    pow_fast_f32(input, count, *exponent, output);
 }
 
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
@@ -3,93 +3,201 @@
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "mul_f32"
-static inline void mul_f32(
-	const float* restrict a,
-	const float* restrict b,
-	int l, int g1, int m, int g2, int r,
-	float* restrict output)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Add/broadcast.h:binary_broadcast"
+
+static inline void __mul_row_f32(const float* x, int x_inner, const float* y, int y_inner, float* out, int count)
 {
-	int index = 0;
-	for (int x = 0; x < l; x++) {
-		for (int i = 0; i < g1; i++) {
-			for (int y = 0; y < m; y++) {
-				for (int j = 0; j < g2; j++) {
-					for (int z = 0; z < r; z++) {
-						output[index] = a[index] * b[x * m * r + y * r + z];
-						index++;
-					}
-				}
-			}
+	if (x_inner && y_inner) {
+		for (int i = 0; i < count; i++) {
+			out[i] = x[i] * y[i];
+		}
+	}
+	else if (x_inner) {
+		const float v = y[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = x[i] * v;
 		}
 	}
+	else if (y_inner) {
+		const float u = x[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = u * y[i];
+		}
+	}
+	else {
+		const float r = x[0] * y[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = r;
+		}
+	}
+}
+
+// a0..a4, b0..b4: operand shapes, innermost dimension first, padded with 1
+// output (broadcast shape of a and b), may be the buffer of an operand with the same shape
+static inline void mul_f32(
+	const float* a,
+	const float* b,
+	int a0, int a1, int a2, int a3, int a4,
+	int b0, int b1, int b2, int b3, int b4,
+	float* output)
+{
+	const int a_shape[BROADCAST_MAX_DIMS] = { a0, a1, a2, a3, a4 };
+	const int b_shape[BROADCAST_MAX_DIMS] = { b0, b1, b2, b3, b4 };
+	binary_broadcast bc;
+	binary_broadcast_init(&bc, a_shape, b_shape);
+	for (int row = 0; row < bc.rows; row++) {
+		__mul_row_f32(a + bc.a_offset, bc.a_inner, b + bc.b_offset, bc.b_inner, output + row * bc.inner, bc.inner);
+		binary_broadcast_next(&bc);
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "mul_i8"
-static inline void mul_i8(
-	const int8_t* restrict a,
-	const int8_t* restrict b,
-	int l, int g1, int m, int g2, int r,
-	int8_t* restrict output)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Add/broadcast.h:binary_broadcast"
+
+static inline void __mul_row_i8(const int8_t* x, int x_inner, const int8_t* y, int y_inner, int8_t* out, int count)
 {
-	int index = 0;
-	for (int x = 0; x < l; x++) {
-		for (int i = 0; i < g1; i++) {
-			for (int y = 0; y < m; y++) {
-				for (int j = 0; j < g2; j++) {
-					for (int z = 0; z < r; z++) {
-						output[index] = a[index] * b[x * m * r + y * r + z];
-						index++;
-					}
-				}
-			}
+	if (x_inner && y_inner) {
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i8((int32_t)x[i] * y[i]);
+		}
+	}
+	else if (x_inner) {
+		const int8_t v = y[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i8((int32_t)x[i] * v);
 		}
 	}
+	else if (y_inner) {
+		const int8_t u = x[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i8((int32_t)u * y[i]);
+		}
+	}
+	else {
+		const int8_t r = __broadcast_sat_i8((int32_t)x[0] * y[0]);
+		for (int i = 0; i < count; i++) {
+			out[i] = r;
+		}
+	}
+}
+
+// a0..a4, b0..b4: operand shapes, innermost dimension first, padded with 1
+// output (broadcast shape of a and b), may be the buffer of an operand with the same shape
+static inline void mul_i8(
+	const int8_t* a,
+	const int8_t* b,
+	int a0, int a1, int a2, int a3, int a4,
+	int b0, int b1, int b2, int b3, int b4,
+	int8_t* output)
+{
+	const int a_shape[BROADCAST_MAX_DIMS] = { a0, a1, a2, a3, a4 };
+	const int b_shape[BROADCAST_MAX_DIMS] = { b0, b1, b2, b3, b4 };
+	binary_broadcast bc;
+	binary_broadcast_init(&bc, a_shape, b_shape);
+	for (int row = 0; row < bc.rows; row++) {
+		__mul_row_i8(a + bc.a_offset, bc.a_inner, b + bc.b_offset, bc.b_inner, output + row * bc.inner, bc.inner);
+		binary_broadcast_next(&bc);
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "mul_i16"
-static inline void mul_i16(
-	const int16_t* restrict a,
-	const int16_t* restrict b,
-	int l, int g1, int m, int g2, int r,
-	int16_t* restrict output)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Add/broadcast.h:binary_broadcast"
+
+static inline void __mul_row_i16(const int16_t* x, int x_inner, const int16_t* y, int y_inner, int16_t* out, int count)
 {
-	int index = 0;
-	for (int x = 0; x < l; x++) {
-		for (int i = 0; i < g1; i++) {
-			for (int y = 0; y < m; y++) {
-				for (int j = 0; j < g2; j++) {
-					for (int z = 0; z < r; z++) {
-						output[index] = a[index] * b[x * m * r + y * r + z];
-						index++;
-					}
-				}
-			}
+	if (x_inner && y_inner) {
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i16((int32_t)x[i] * y[i]);
+		}
+	}
+	else if (x_inner) {
+		const int16_t v = y[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i16((int32_t)x[i] * v);
 		}
 	}
+	else if (y_inner) {
+		const int16_t u = x[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i16((int32_t)u * y[i]);
+		}
+	}
+	else {
+		const int16_t r = __broadcast_sat_i16((int32_t)x[0] * y[0]);
+		for (int i = 0; i < count; i++) {
+			out[i] = r;
+		}
+	}
+}
+
+// a0..a4, b0..b4: operand shapes, innermost dimension first, padded with 1
+// output (broadcast shape of a and b), may be the buffer of an operand with the same shape
+static inline void mul_i16(
+	const int16_t* a,
+	const int16_t* b,
+	int a0, int a1, int a2, int a3, int a4,
+	int b0, int b1, int b2, int b3, int b4,
+	int16_t* output)
+{
+	const int a_shape[BROADCAST_MAX_DIMS] = { a0, a1, a2, a3, a4 };
+	const int b_shape[BROADCAST_MAX_DIMS] = { b0, b1, b2, b3, b4 };
+	binary_broadcast bc;
+	binary_broadcast_init(&bc, a_shape, b_shape);
+	for (int row = 0; row < bc.rows; row++) {
+		__mul_row_i16(a + bc.a_offset, bc.a_inner, b + bc.b_offset, bc.b_inner, output + row * bc.inner, bc.inner);
+		binary_broadcast_next(&bc);
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "mul_i32"
-static inline void mul_i32(
-	const int32_t* restrict a,
-	const int32_t* restrict b,
-	int l, int g1, int m, int g2, int r,
-	int32_t* restrict output)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Add/broadcast.h:binary_broadcast"
+
+static inline void __mul_row_i32(const int32_t* x, int x_inner, const int32_t* y, int y_inner, int32_t* out, int count)
 {
-	int index = 0;
-	for (int x = 0; x < l; x++) {
-		for (int i = 0; i < g1; i++) {
-			for (int y = 0; y < m; y++) {
-				for (int j = 0; j < g2; j++) {
-					for (int z = 0; z < r; z++) {
-						output[index] = a[index] * b[x * m * r + y * r + z];
-						index++;
-					}
-				}
-			}
+	if (x_inner && y_inner) {
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i32((int64_t)x[i] * y[i]);
+		}
+	}
+	else if (x_inner) {
+		const int32_t v = y[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i32((int64_t)x[i] * v);
 		}
 	}
+	else if (y_inner) {
+		const int32_t u = x[0];
+		for (int i = 0; i < count; i++) {
+			out[i] = __broadcast_sat_i32((int64_t)u * y[i]);
+		}
+	}
+	else {
+		const int32_t r = __broadcast_sat_i32((int64_t)x[0] * y[0]);
+		for (int i = 0; i < count; i++) {
+			out[i] = r;
+		}
+	}
+}
+
+// a0..a4, b0..b4: operand shapes, innermost dimension first, padded with 1
+// output (broadcast shape of a and b), may be the buffer of an operand with the same shape
+static inline void mul_i32(
+	const int32_t* a,
+	const int32_t* b,
+	int a0, int a1, int a2, int a3, int a4,
+	int b0, int b1, int b2, int b3, int b4,
+	int32_t* output)
+{
+	const int a_shape[BROADCAST_MAX_DIMS] = { a0, a1, a2, a3, a4 };
+	const int b_shape[BROADCAST_MAX_DIMS] = { b0, b1, b2, b3, b4 };
+	binary_broadcast bc;
+	binary_broadcast_init(&bc, a_shape, b_shape);
+	for (int row = 0; row < bc.rows; row++) {
+		__mul_row_i32(a + bc.a_offset, bc.a_inner, b + bc.b_offset, bc.b_inner, output + row * bc.inner, bc.inner);
+		binary_broadcast_next(&bc);
+	}
 }
 #pragma IMAGINET_FRAGMENT_END
@@ -5,6 +5,11 @@ import numpy as np
 #pragma IMAGINET_FRAGMENT_BEGIN "mul"
 
 def mul(a, b, output):
-    np.multiply(a, b, out=output)
+    if np.issubdtype(output.dtype, np.integer):
+        # Integer results saturate to the range of the output type
+        info = np.iinfo(output.dtype)
+        np.copyto(output, np.clip(np.multiply(a, b, dtype=np.int64), info.min, info.max), casting="unsafe")
+    else:
+        np.multiply(a, b, out=output)
 
 #pragma IMAGINET_FRAGMENT_END
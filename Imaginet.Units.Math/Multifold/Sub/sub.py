@@ -5,6 +5,11 @@ import numpy as np
 #pragma IMAGINET_FRAGMENT_BEGIN "sub"
 
 def sub(a, b, output):
-    np.subtract(a,b, out=output)
+    if np.issubdtype(output.dtype, np.integer):
+        # Integer results saturate to the range of the output type
+        info = np.iinfo(output.dtype)
+        np.copyto(output, np.clip(np.subtract(a, b, dtype=np.int64), info.min, info.max), casting="unsafe")
+    else:
+        np.subtract(a, b, out=output)
 
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
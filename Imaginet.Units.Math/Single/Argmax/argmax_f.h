@@ -1,21 +1,54 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <float.h>
+#include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "arg_lanes"
+// Independent lanes used along a contiguous axis, and outputs tracked together otherwise.
+// Plain arrays with branch-free selects, so the compiler maps them onto SIMD registers.
+#define ARG_LANES 8
+#define ARG_COLS 64
+#pragma IMAGINET_FRAGMENT_END
+
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "arg_lanes"
 
-static inline int16_t __argmax_f32(const float* restrict input, int step, int count)
+// Contiguous axis: every lane keeps the maximum and its first index over every ARG_LANES-th element,
+// the lanes are combined (smallest index wins a tie) and the tail is finished in order.
+static inline int16_t __argmax_f32(const float* restrict input, int count)
 {
-	float max = -FLT_MAX;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		float value = input[i * step];
-		if (value > max) {
+	float lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = -FLT_MAX;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const float value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	float max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -23,17 +56,41 @@ static inline int16_t __argmax_f32(const float* restrict input, int step, int co
 // d0 = input.shape.step(axis)
 // d1 = input.shape.size(axis)
 // d2 = input.shape.slot(axis)
+// With d0 > 1, blocks of ARG_COLS adjacent outputs are tracked together and updated one input row
+// at a time, so memory is read in order and the compare/select loop vectorizes across columns.
 static inline void argmax_f32(const float* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_f32(input + i + id, d0, d1);
+		const float* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_f32(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			float value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = -FLT_MAX;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const float* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
-
-
@@ -1,20 +1,47 @@
 #pragma IMAGINET_INCLUDES_BEGIN
-#include <float.h>
+#include <limits.h>
+#include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
+// Same lane scheme as argmax_f32 (argmax_f.h).
+
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_i32"
-static inline int16_t __argmax_i32(const int32_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_i32(const int32_t* restrict input, int count)
 {
-	int32_t max = INT_MIN;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		int32_t value = input[i * step];
-		if (value > max) {
+	int32_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = INT_MIN;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const int32_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	int32_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -24,32 +51,79 @@ static inline int16_t __argmax_i32(const int32_t* restrict input, int step, int
 // d2 = input.shape.slot(axis)
 static inline void argmax_i32(const int32_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_i32(input + i + id, d0, d1);
+		const int32_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_i32(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			int32_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = INT_MIN;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const int32_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 
-
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_i16"
-static inline int16_t __argmax_i16(const int16_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_i16(const int16_t* restrict input, int count)
 {
-	int16_t max = SHRT_MIN;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		int16_t value = input[i * step];
-		if (value > max) {
+	int16_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = SHRT_MIN;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const int16_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	int16_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -59,12 +133,36 @@ static inline int16_t __argmax_i16(const int16_t* restrict input, int step, int
 // d2 = input.shape.slot(axis)
 static inline void argmax_i16(const int16_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_i16(input + i + id, d0, d1);
+		const int16_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_i16(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			int16_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = SHRT_MIN;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const int16_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
@@ -72,18 +170,42 @@ static inline void argmax_i16(const int16_t* restrict input, int d0, int d1, int
 
 
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_i8"
-static inline int16_t __argmax_i8(const int8_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_i8(const int8_t* restrict input, int count)
 {
-	int8_t max = SCHAR_MIN;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		int8_t value = input[i * step];
-		if (value > max) {
+	int8_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = SCHAR_MIN;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const int8_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	int8_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -93,30 +215,79 @@ static inline int16_t __argmax_i8(const int8_t* restrict input, int step, int co
 // d2 = input.shape.slot(axis)
 static inline void argmax_i8(const int8_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_i8(input + i + id, d0, d1);
+		const int8_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_i8(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			int8_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = SCHAR_MIN;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const int8_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
+
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_u32"
-static inline int16_t __argmax_u32(const uint32_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_u32(const uint32_t* restrict input, int count)
 {
-	uint32_t max = 0;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		uint32_t value = input[i * step];
-		if (value > max) {
+	uint32_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = 0;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const uint32_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	uint32_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -126,12 +297,36 @@ static inline int16_t __argmax_u32(const uint32_t* restrict input, int step, int
 // d2 = input.shape.slot(axis)
 static inline void argmax_u32(const uint32_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_u32(input + i + id, d0, d1);
+		const uint32_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_u32(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			uint32_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = 0;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const uint32_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
@@ -139,18 +334,42 @@ static inline void argmax_u32(const uint32_t* restrict input, int d0, int d1, in
 
 
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_u16"
-static inline int16_t __argmax_u16(const uint16_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_u16(const uint16_t* restrict input, int count)
 {
-	uint16_t max = 0;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		uint16_t value = input[i * step];
-		if (value > max) {
+	uint16_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = 0;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const uint16_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	uint16_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -160,12 +379,36 @@ static inline int16_t __argmax_u16(const uint16_t* restrict input, int step, int
 // d2 = input.shape.slot(axis)
 static inline void argmax_u16(const uint16_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_u16(input + i + id, d0, d1);
+		const uint16_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_u16(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			uint16_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = 0;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const uint16_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
@@ -173,18 +416,42 @@ static inline void argmax_u16(const uint16_t* restrict input, int d0, int d1, in
 
 
 #pragma IMAGINET_FRAGMENT_BEGIN "argmax_u8"
-static inline int16_t __argmax_u8(const uint8_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "argmax_f.h:arg_lanes"
+
+static inline int16_t __argmax_u8(const uint8_t* restrict input, int count)
 {
-	uint8_t max = 0;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		uint8_t value = input[i * step];
-		if (value > max) {
+	uint8_t lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = 0;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const uint8_t value = input[i + l];
+			const int greater = value > lane_value[l];
+			lane_value[l] = greater ? value : lane_value[l];
+			lane_index[l] = greater ? i + l : lane_index[l];
+		}
+	}
+
+	uint8_t max = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] > max || (lane_value[l] == max && lane_index[l] < index)) {
+			max = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] > max) {
+			max = input[i];
 			index = i;
-			max = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -194,12 +461,36 @@ static inline int16_t __argmax_u8(const uint8_t* restrict input, int step, int c
 // d2 = input.shape.slot(axis)
 static inline void argmax_u8(const uint8_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmax_u8(input + i + id, d0, d1);
+		const uint8_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmax_u8(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			uint8_t value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = 0;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const uint8_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int greater = row[i] > value[i];
+					value[i] = greater ? row[i] : value[i];
+					index[i] = greater ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
@@ -3,20 +3,45 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
+// Same lane scheme as argmax_f32.
+
 #pragma IMAGINET_FRAGMENT_BEGIN "argmin_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Argmax/argmax_f.h:arg_lanes"
 
-static inline int16_t __argmin_f32(const float* restrict input, int step, int count)
+static inline int16_t __argmin_f32(const float* restrict input, int count)
 {
-	float min = FLT_MIN;
-	int16_t index = 0;
-	for (int i = 0; i < count; i++) {
-		float value = input[i * step];
-		if (value < min) {
+	float lane_value[ARG_LANES];
+	int32_t lane_index[ARG_LANES];
+	for (int l = 0; l < ARG_LANES; l++) {
+		lane_value[l] = FLT_MAX;
+		lane_index[l] = 0;
+	}
+
+	int i = 0;
+	for (; i + ARG_LANES <= count; i += ARG_LANES) {
+		for (int l = 0; l < ARG_LANES; l++) {
+			const float value = input[i + l];
+			const int less = value < lane_value[l];
+			lane_value[l] = less ? value : lane_value[l];
+			lane_index[l] = less ? i + l : lane_index[l];
+		}
+	}
+
+	float min = lane_value[0];
+	int32_t index = lane_index[0];
+	for (int l = 1; l < ARG_LANES; l++) {
+		if (lane_value[l] < min || (lane_value[l] == min && lane_index[l] < index)) {
+			min = lane_value[l];
+			index = lane_index[l];
+		}
+	}
+	for (; i < count; i++) {
+		if (input[i] < min) {
+			min = input[i];
 			index = i;
-			min = value;
 		}
 	}
-	return index;
+	return (int16_t)index;
 }
 
 // input array (any shape >= 2D)
@@ -26,15 +51,37 @@ static inline int16_t __argmin_f32(const float* restrict input, int step, int co
 // d2 = input.shape.slot(axis)
 static inline void argmin_f32(const float* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	int d3 = d0 * d1;
+	const int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __argmin_f32(input + i + id, d0, d1);
+		const float* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __argmin_f32(x, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += ARG_COLS) {
+			const int cols = d0 - c < ARG_COLS ? d0 - c : ARG_COLS;
+			float value[ARG_COLS];
+			int16_t index[ARG_COLS];
+			for (int i = 0; i < cols; i++) {
+				value[i] = FLT_MAX;
+				index[i] = 0;
+			}
+			for (int j = 0; j < d1; j++) {
+				const float* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int less = row[i] < value[i];
+					value[i] = less ? row[i] : value[i];
+					index[i] = less ? (int16_t)j : index[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = index[i];
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
-
-
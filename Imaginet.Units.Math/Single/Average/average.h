@@ -2,99 +2,158 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "average_f32"
-
-static inline float __average_f32(const float* input, int step, int count)
+#pragma IMAGINET_FRAGMENT_BEGIN "average_scale_f32"
+static inline void __average_scale_f32(float* restrict output, int count, int d1)
 {
-	float avg = 0;
+	const float inv_count = 1.0f / (float)d1;
 	for (int i = 0; i < count; i++) {
-		avg += input[i * step];
+		output[i] *= inv_count;
 	}
-
-	return avg / (float)count;
 }
+#pragma IMAGINET_FRAGMENT_END
 
 // input array (any shape >= 2D)
 // output array (input.shape.remove(axis))
 // d0 = input.shape.step(axis)
 // d1 = input.shape.size(axis)
 // d2 = input.shape.slot(axis)
-static inline void average_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
-{
-	const int d3 = d0 * d1;
+// Sums with the reduction of Sum of the selected precision, then scales.
 
-	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __average_f32(input + i + id, d0, d1);
-		}
-	}
+#pragma IMAGINET_FRAGMENT_BEGIN "average_naive_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sum/sum.h:sum_naive_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_scale_f32"
+static inline void average_naive_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
+{
+	sum_naive_f32(input, d0, d1, d2, output);
+	__average_scale_f32(output, d0 * d2, d1);
 }
+#pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "average_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sum/sum.h:sum_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_scale_f32"
+static inline void average_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
+{
+	sum_f32(input, d0, d1, d2, output);
+	__average_scale_f32(output, d0 * d2, d1);
+}
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "average_i8"
-static inline int8_t __average_i8(const int8_t* input, int step, int count)
+#pragma IMAGINET_FRAGMENT_BEGIN "average_kahan_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sum/sum.h:sum_kahan_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_scale_f32"
+static inline void average_kahan_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
 {
-	int32_t sum = 0;
-	for (int i = 0; i < count; i++) {
-		sum += input[i * step];
-	}
-	return (int8_t)(sum / count);
+	sum_kahan_f32(input, d0, d1, d2, output);
+	__average_scale_f32(output, d0 * d2, d1);
 }
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "average_int"
+#define AVERAGE_COLS 64
+#pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "average_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_int"
 static inline void average_i8(const int8_t* restrict input, int d0, int d1, int d2, int8_t* restrict output)
 {
 	const int d3 = d0 * d1;
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __average_i8(input + i + id, d0, d1);
+		const int8_t* x = input + k * d3;
+		int8_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			int32_t sum = 0;
+			for (int j = 0; j < d1; j++) {
+				sum += x[j];
+			}
+			out[0] = (int8_t)(sum / d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += AVERAGE_COLS) {
+			const int cols = d0 - c < AVERAGE_COLS ? d0 - c : AVERAGE_COLS;
+			int32_t acc[AVERAGE_COLS] = { 0 };
+			for (int j = 0; j < d1; j++) {
+				const int8_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = (int8_t)(acc[i] / d1);
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "average_i16"
-static inline int16_t __average_i16(const int16_t* input, int step, int count)
-{
-	int32_t sum = 0;
-	for (int i = 0; i < count; i++) {
-		sum += input[i * step];
-	}
-	return (int16_t)(sum / count);
-}
-
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_int"
 static inline void average_i16(const int16_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
 	const int d3 = d0 * d1;
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __average_i16(input + i + id, d0, d1);
+		const int16_t* x = input + k * d3;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			int32_t sum = 0;
+			for (int j = 0; j < d1; j++) {
+				sum += x[j];
+			}
+			out[0] = (int16_t)(sum / d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += AVERAGE_COLS) {
+			const int cols = d0 - c < AVERAGE_COLS ? d0 - c : AVERAGE_COLS;
+			int32_t acc[AVERAGE_COLS] = { 0 };
+			for (int j = 0; j < d1; j++) {
+				const int16_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = (int16_t)(acc[i] / d1);
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "average_i32"
-static inline int32_t __average_i32(const int32_t* input, int step, int count)
-{
-	int64_t sum = 0;
-	for (int i = 0; i < count; i++) {
-		sum += input[i * step];
-	}
-	return (int32_t)(sum / count);
-}
-
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "average_int"
 static inline void average_i32(const int32_t* restrict input, int d0, int d1, int d2, int32_t* restrict output)
 {
 	const int d3 = d0 * d1;
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __average_i32(input + i + id, d0, d1);
+		const int32_t* x = input + k * d3;
+		int32_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			int64_t sum = 0;
+			for (int j = 0; j < d1; j++) {
+				sum += x[j];
+			}
+			out[0] = (int32_t)(sum / d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += AVERAGE_COLS) {
+			const int cols = d0 - c < AVERAGE_COLS ? d0 - c : AVERAGE_COLS;
+			int64_t acc[AVERAGE_COLS] = { 0 };
+			for (int j = 0; j < d1; j++) {
+				const int32_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = (int32_t)(acc[i] / d1);
+			}
 		}
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
@@ -3,43 +3,59 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "max_sparse_f32"
-
-static inline float __max_sparse_f32(const float* restrict input, int step, int size)
-{
-	float max_value = -FLT_MAX;
-	for (int i = 0; i < size; i++) {
-		float value = *input;
-		if (value > max_value)
-			max_value = value;	
-		input += step;
-	}
-	return max_value;
-}
+#pragma IMAGINET_FRAGMENT_BEGIN "max_lanes"
+#define MAX_LANES 8
+#pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "max_sparse_f32"
+// Rows of the reduced axis are 'step' elements apart: the outputs of a slot are updated one input
+// row at a time, so memory is read in order and the loop vectorizes across outputs.
 static inline void max_sparse_f32(const float* restrict input, int step, int size, int slot, float* restrict output)
 {
 	int d3 = step * size;
 
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __max_sparse_f32(input + i, step, size);
+			output[i] = -FLT_MAX;
+		}
+		for (int j = 0; j < size; j++) {
+			const float* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] > output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
-
 #pragma IMAGINET_FRAGMENT_BEGIN "max_f32"
-
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "max_lanes"
+// Contiguous axis: MAX_LANES independent running values, combined at the end.
 static inline float __max_f32(const float* restrict input, int size)
 {
-	float max_value = -FLT_MAX;
-	for (int i = 0; i < size; i++) {
-		float value = *input++;
-		if (value > max_value)
-			max_value = value;
+	float lane[MAX_LANES];
+	for (int l = 0; l < MAX_LANES; l++) {
+		lane[l] = -FLT_MAX;
+	}
+
+	int i = 0;
+	for (; i + MAX_LANES <= size; i += MAX_LANES) {
+		for (int l = 0; l < MAX_LANES; l++) {
+			const float value = input[i + l];
+			lane[l] = value > lane[l] ? value : lane[l];
+		}
+	}
+
+	float max_value = lane[0];
+	for (int l = 1; l < MAX_LANES; l++) {
+		if (lane[l] > max_value)
+			max_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] > max_value)
+			max_value = input[i];
 	}
 	return max_value;
 }
@@ -54,38 +70,51 @@ static inline void max_f32(const float* restrict input, int size, int slot, floa
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_sparse_i8"
-static inline int8_t __max_sparse_i8(const int8_t* restrict input, int step, int size)
-{
-	int8_t max_value = INT8_MIN;
-	for (int i = 0; i < size; i++) {
-		int8_t value = *input;
-		if (value > max_value)
-			max_value = value;
-		input += step;
-	}
-	return max_value;
-}
-
 static inline void max_sparse_i8(const int8_t* restrict input, int step, int size, int slot, int8_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __max_sparse_i8(input + i, step, size);
+			output[i] = INT8_MIN;
+		}
+		for (int j = 0; j < size; j++) {
+			const int8_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] > output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "max_lanes"
 static inline int8_t __max_i8(const int8_t* restrict input, int size)
 {
-	int8_t max_value = INT8_MIN;
-	for (int i = 0; i < size; i++) {
-		int8_t value = *input++;
-		if (value > max_value)
-			max_value = value;
+	int8_t lane[MAX_LANES];
+	for (int l = 0; l < MAX_LANES; l++) {
+		lane[l] = INT8_MIN;
+	}
+
+	int i = 0;
+	for (; i + MAX_LANES <= size; i += MAX_LANES) {
+		for (int l = 0; l < MAX_LANES; l++) {
+			const int8_t value = input[i + l];
+			lane[l] = value > lane[l] ? value : lane[l];
+		}
+	}
+
+	int8_t max_value = lane[0];
+	for (int l = 1; l < MAX_LANES; l++) {
+		if (lane[l] > max_value)
+			max_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] > max_value)
+			max_value = input[i];
 	}
 	return max_value;
 }
@@ -100,38 +129,51 @@ static inline void max_i8(const int8_t* restrict input, int size, int slot, int8
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_sparse_i16"
-static inline int16_t __max_sparse_i16(const int16_t* restrict input, int step, int size)
-{
-	int16_t max_value = INT16_MIN;
-	for (int i = 0; i < size; i++) {
-		int16_t value = *input;
-		if (value > max_value)
-			max_value = value;
-		input += step;
-	}
-	return max_value;
-}
-
 static inline void max_sparse_i16(const int16_t* restrict input, int step, int size, int slot, int16_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __max_sparse_i16(input + i, step, size);
+			output[i] = INT16_MIN;
+		}
+		for (int j = 0; j < size; j++) {
+			const int16_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] > output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "max_lanes"
 static inline int16_t __max_i16(const int16_t* restrict input, int size)
 {
-	int16_t max_value = INT16_MIN;
-	for (int i = 0; i < size; i++) {
-		int16_t value = *input++;
-		if (value > max_value)
-			max_value = value;
+	int16_t lane[MAX_LANES];
+	for (int l = 0; l < MAX_LANES; l++) {
+		lane[l] = INT16_MIN;
+	}
+
+	int i = 0;
+	for (; i + MAX_LANES <= size; i += MAX_LANES) {
+		for (int l = 0; l < MAX_LANES; l++) {
+			const int16_t value = input[i + l];
+			lane[l] = value > lane[l] ? value : lane[l];
+		}
+	}
+
+	int16_t max_value = lane[0];
+	for (int l = 1; l < MAX_LANES; l++) {
+		if (lane[l] > max_value)
+			max_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] > max_value)
+			max_value = input[i];
 	}
 	return max_value;
 }
@@ -146,38 +188,51 @@ static inline void max_i16(const int16_t* restrict input, int size, int slot, in
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_sparse_i32"
-static inline int32_t __max_sparse_i32(const int32_t* restrict input, int step, int size)
-{
-	int32_t max_value = INT32_MIN;
-	for (int i = 0; i < size; i++) {
-		int32_t value = *input;
-		if (value > max_value)
-			max_value = value;
-		input += step;
-	}
-	return max_value;
-}
-
 static inline void max_sparse_i32(const int32_t* restrict input, int step, int size, int slot, int32_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __max_sparse_i32(input + i, step, size);
+			output[i] = INT32_MIN;
+		}
+		for (int j = 0; j < size; j++) {
+			const int32_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] > output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "max_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "max_lanes"
 static inline int32_t __max_i32(const int32_t* restrict input, int size)
 {
-	int32_t max_value = INT32_MIN;
-	for (int i = 0; i < size; i++) {
-		int32_t value = *input++;
-		if (value > max_value)
-			max_value = value;
+	int32_t lane[MAX_LANES];
+	for (int l = 0; l < MAX_LANES; l++) {
+		lane[l] = INT32_MIN;
+	}
+
+	int i = 0;
+	for (; i + MAX_LANES <= size; i += MAX_LANES) {
+		for (int l = 0; l < MAX_LANES; l++) {
+			const int32_t value = input[i + l];
+			lane[l] = value > lane[l] ? value : lane[l];
+		}
+	}
+
+	int32_t max_value = lane[0];
+	for (int l = 1; l < MAX_LANES; l++) {
+		if (lane[l] > max_value)
+			max_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] > max_value)
+			max_value = input[i];
 	}
 	return max_value;
 }
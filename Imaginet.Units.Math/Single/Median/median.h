@@ -1,32 +1,128 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <stdint.h>
+#include <string.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "median_f32"
+// ===== block median =====
+// The input is copied into 'temp' (count elements, provided by the unit) and the middle element is
+// found by introselect: quickselect with a median-of-3 pivot, falling back to a heap selection if
+// the partitioning degenerates, so the worst case stays O(n log n). Ranges of up to
+// MEDIAN_SMALL elements are finished by insertion sort. For an even count the lower middle value
+// is the largest element left of the upper one, found by a scan.
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_select"
 
-static inline void median_f32(const float* restrict input, float* restrict output, int count) 
+#define MEDIAN_SMALL 16
+
+static inline int median_depth_limit(int count)
 {
-    float temp[count];
-    for (int i = 0; i < count; ++i) {
-        temp[i] = input[i];
+    int depth = 0;
+    while (count > 1) {
+        count >>= 1;
+        depth += 2;
     }
+    return depth;
+}
 
-    // Insertion sort
-    for (int i = 1; i < count; ++i) {
-        float key = temp[i];
-        int j = i - 1;
-        while (j >= 0 && temp[j] > key) {
-            temp[j + 1] = temp[j];
-            j--;
-        }
-        temp[j + 1] = key;
-    }
+// Defines median_sift_<suffix> and median_select_<suffix> for one element type.
+// median_select_<suffix>(a, n, k) rearranges a[0..n) so that a[k] holds the value it would have
+// if sorted, with no larger value before it and no smaller value after it.
+#define MEDIAN_DEFINE_SELECT(suffix, type)                                                          \
+static inline void median_sift_##suffix(type* restrict a, int root, int n)                          \
+{                                                                                                   \
+    type v = a[root];                                                                               \
+    for (;;) {                                                                                      \
+        int child = 2 * root + 1;                                                                   \
+        if (child >= n)                                                                             \
+            break;                                                                                  \
+        if (child + 1 < n && a[child + 1] > a[child])                                               \
+            child++;                                                                                \
+        if (a[child] <= v)                                                                          \
+            break;                                                                                  \
+        a[root] = a[child];                                                                         \
+        root = child;                                                                               \
+    }                                                                                               \
+    a[root] = v;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+static inline void median_select_##suffix(type* restrict a, int n, int k)                           \
+{                                                                                                   \
+    int lo = 0, hi = n - 1;                                                                         \
+    int depth = median_depth_limit(n);                                                              \
+                                                                                                    \
+    while (hi - lo >= MEDIAN_SMALL) {                                                               \
+        if (depth-- == 0) {                                                                         \
+            /* Heap selection on [lo, hi]: max-heap of the k - lo + 1 smallest values. */           \
+            type* h = a + lo;                                                                       \
+            int m = k - lo + 1;                                                                     \
+            for (int i = m / 2 - 1; i >= 0; i--)                                                    \
+                median_sift_##suffix(h, i, m);                                                      \
+            for (int i = m; i <= hi - lo; i++) {                                                    \
+                if (h[i] < h[0]) {                                                                  \
+                    type t = h[i]; h[i] = h[0]; h[0] = t;                                           \
+                    median_sift_##suffix(h, 0, m);                                                  \
+                }                                                                                   \
+            }                                                                                       \
+            type t = h[0]; h[0] = h[m - 1]; h[m - 1] = t;                                           \
+            return;                                                                                 \
+        }                                                                                           \
+                                                                                                    \
+        /* Median-of-3 pivot, leaving a[lo] <= a[mid] <= a[hi] as sentinels. */                     \
+        int mid = lo + (hi - lo) / 2;                                                               \
+        if (a[mid] < a[lo]) { type t = a[mid]; a[mid] = a[lo]; a[lo] = t; }                         \
+        if (a[hi] < a[lo]) { type t = a[hi]; a[hi] = a[lo]; a[lo] = t; }                            \
+        if (a[hi] < a[mid]) { type t = a[hi]; a[hi] = a[mid]; a[mid] = t; }                         \
+        const type pivot = a[mid];                                                                  \
+                                                                                                    \
+        int i = lo, j = hi;                                                                         \
+        for (;;) {                                                                                  \
+            do i++; while (a[i] < pivot);                                                           \
+            do j--; while (a[j] > pivot);                                                           \
+            if (i >= j)                                                                             \
+                break;                                                                              \
+            type t = a[i]; a[i] = a[j]; a[j] = t;                                                   \
+        }                                                                                           \
+        if (k <= j)                                                                                 \
+            hi = j;                                                                                 \
+        else                                                                                        \
+            lo = j + 1;                                                                             \
+    }                                                                                               \
+                                                                                                    \
+    for (int i = lo + 1; i <= hi; i++) {                                                            \
+        type key = a[i];                                                                            \
+        int j = i - 1;                                                                              \
+        while (j >= lo && a[j] > key) {                                                             \
+            a[j + 1] = a[j];                                                                        \
+            j--;                                                                                    \
+        }                                                                                           \
+        a[j + 1] = key;                                                                             \
+    }                                                                                               \
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_select"
+
+MEDIAN_DEFINE_SELECT(f32, float)
+
+static inline void median_f32(const float* restrict input, float* restrict output, int count, float* restrict temp)
+{
+    memcpy(temp, input, count * sizeof(float));
+
+    const int k = count / 2;
+    median_select_f32(temp, count, k);
 
     if (count % 2) {
-        *output = temp[count / 2];
+        *output = temp[k];
     }
     else {
-        *output = (temp[count / 2 - 1] + temp[count / 2]) * 0.5f;
+        float low = temp[0];
+        for (int i = 1; i < k; i++) {
+            if (temp[i] > low)
+                low = temp[i];
+        }
+        *output = (low + temp[k]) * 0.5f;
     }
 }
 
@@ -34,87 +130,330 @@ static inline void median_f32(const float* restrict input, float* restrict outpu
 
 #pragma IMAGINET_FRAGMENT_BEGIN "median_i8"
 
+// int8 has only 256 values, so the median is found by counting instead of selecting:
+// O(n), no temporary copy of the input.
 static inline void median_i8(const int8_t* restrict input, int8_t* restrict output, int count)
 {
-    int8_t temp[count];
+    int32_t hist[256] = { 0 };
     for (int i = 0; i < count; ++i) {
-        temp[i] = input[i];
+        hist[input[i] + 128]++;
     }
 
-    for (int i = 1; i < count; ++i) {
-        int8_t key = temp[i];
-        int j = i - 1;
-        while (j >= 0 && temp[j] > key) {
-            temp[j + 1] = temp[j];
-            j--;
+    // 0-based ranks of the lower and upper middle values.
+    const int r_low = (count - 1) / 2;
+    const int r_high = count / 2;
+    int low = -128, high = -128;
+    int seen = 0;
+    for (int v = 0; v < 256; v++) {
+        if (seen <= r_low)
+            low = v - 128;
+        seen += hist[v];
+        if (seen > r_high) {
+            high = v - 128;
+            break;
         }
-        temp[j + 1] = key;
     }
 
     if (count % 2) {
-        *output = temp[count / 2];
+        *output = (int8_t)low;
     }
     else {
-        *output = (int8_t)(((int16_t)temp[count / 2 - 1] + temp[count / 2]) / 2);
+        *output = (int8_t)(((int16_t)low + high) / 2);
     }
 }
 
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "median_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_select"
+
+MEDIAN_DEFINE_SELECT(i16, int16_t)
 
-static inline void median_i16(const int16_t* restrict input, int16_t* restrict output, int count)
+static inline void median_i16(const int16_t* restrict input, int16_t* restrict output, int count, int16_t* restrict temp)
 {
-    int16_t temp[count];
-    for (int i = 0; i < count; ++i) {
-        temp[i] = input[i];
-    }
+    memcpy(temp, input, count * sizeof(int16_t));
+
+    const int k = count / 2;
+    median_select_i16(temp, count, k);
 
-    for (int i = 1; i < count; ++i) {
-        int16_t key = temp[i];
-        int j = i - 1;
-        while (j >= 0 && temp[j] > key) {
-            temp[j + 1] = temp[j];
-            j--;
+    if (count % 2) {
+        *output = temp[k];
+    }
+    else {
+        int16_t low = temp[0];
+        for (int i = 1; i < k; i++) {
+            if (temp[i] > low)
+                low = temp[i];
         }
-        temp[j + 1] = key;
+        *output = (int16_t)(((int32_t)low + temp[k]) / 2);
     }
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_select"
+
+MEDIAN_DEFINE_SELECT(i32, int32_t)
+
+static inline void median_i32(const int32_t* restrict input, int32_t* restrict output, int count, int32_t* restrict temp)
+{
+    memcpy(temp, input, count * sizeof(int32_t));
+
+    const int k = count / 2;
+    median_select_i32(temp, count, k);
 
     if (count % 2) {
-        *output = temp[count / 2];
+        *output = temp[k];
     }
     else {
-        *output = (int16_t)(((int32_t)temp[count / 2 - 1] + temp[count / 2]) / 2);
+        int32_t low = temp[0];
+        for (int i = 1; i < k; i++) {
+            if (temp[i] > low)
+                low = temp[i];
+        }
+        *output = (int32_t)(((int64_t)low + temp[k]) / 2);
     }
 }
 
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "median_i32"
 
-static inline void median_i32(const int32_t* restrict input, int32_t* restrict output, int count)
+// ===== sliding median =====
+// Running median over the last 'window' samples, updated in O(log window) per sample with two
+// indexed heaps: a max-heap with the lower half and a min-heap with the upper half of the window.
+// Every sample is stored as an int32 key whose order matches the order of the values (floats are
+// mapped by their bit pattern), so one implementation serves all data types.
+//
+// Handle layout (size = 20 + window * 16 bytes):
+//   median_window_state header
+//   int32_t key[window]       ring buffer of the window, oldest sample at 'pos' once full
+//   int32_t low[window]       max-heap of ring slots (lower half)
+//   int32_t high[window]      min-heap of ring slots (upper half)
+//   int32_t where[window]     heap position of every slot: i >= 0 in low, ~i in high
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_window"
+
+typedef struct {
+    int32_t window;
+    int32_t filled;
+    int32_t pos;
+    int32_t n_low;
+    int32_t n_high;
+} median_window_state;
+
+static inline int32_t* median_window_keys(void* state_ptr)
 {
-    int32_t temp[count];
-    for (int i = 0; i < count; ++i) {
-        temp[i] = input[i];
+    return (int32_t*)((char*)state_ptr + sizeof(median_window_state));
+}
+
+static inline int median_window_init(int8_t* restrict state_bytes, int window)
+{
+    median_window_state* state = (median_window_state*)state_bytes;
+    state->window = window;
+    state->filled = 0;
+    state->pos = 0;
+    state->n_low = 0;
+    state->n_high = 0;
+    return 0;
+}
+
+// Heap 'h' of n slots ordered by key; sign is +1 for the max-heap and -1 for the min-heap.
+// tag(i) is the value stored in 'where' for heap position i.
+static inline int median_heap_before(const int32_t* key, int32_t a, int32_t b, int sign)
+{
+    return sign > 0 ? key[a] > key[b] : key[a] < key[b];
+}
+
+static inline void median_heap_set(int32_t* h, int32_t* where, int i, int32_t slot, int sign)
+{
+    h[i] = slot;
+    where[slot] = sign > 0 ? i : ~i;
+}
+
+static inline void median_heap_up(const int32_t* key, int32_t* h, int32_t* where, int i, int sign)
+{
+    const int32_t slot = h[i];
+    while (i > 0) {
+        const int parent = (i - 1) / 2;
+        if (!median_heap_before(key, slot, h[parent], sign))
+            break;
+        median_heap_set(h, where, i, h[parent], sign);
+        i = parent;
     }
+    median_heap_set(h, where, i, slot, sign);
+}
 
-    for (int i = 1; i < count; ++i) {
-        int32_t key = temp[i];
-        int j = i - 1;
-        while (j >= 0 && temp[j] > key) {
-            temp[j + 1] = temp[j];
-            j--;
-        }
-        temp[j + 1] = key;
+static inline void median_heap_down(const int32_t* key, int32_t* h, int32_t* where, int n, int i, int sign)
+{
+    const int32_t slot = h[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && median_heap_before(key, h[child + 1], h[child], sign))
+            child++;
+        if (!median_heap_before(key, h[child], slot, sign))
+            break;
+        median_heap_set(h, where, i, h[child], sign);
+        i = child;
     }
+    median_heap_set(h, where, i, slot, sign);
+}
 
-    if (count % 2) {
-        *output = temp[count / 2];
+static inline void median_heap_push(const int32_t* key, int32_t* h, int32_t* where, int* n, int32_t slot, int sign)
+{
+    median_heap_set(h, where, *n, slot, sign);
+    median_heap_up(key, h, where, (*n)++, sign);
+}
+
+static inline int32_t median_heap_pop(const int32_t* key, int32_t* h, int32_t* where, int* n, int sign)
+{
+    const int32_t top = h[0];
+    if (--(*n) > 0) {
+        median_heap_set(h, where, 0, h[*n], sign);
+        median_heap_down(key, h, where, *n, 0, sign);
+    }
+    return top;
+}
+
+static inline void median_heap_remove(const int32_t* key, int32_t* h, int32_t* where, int* n, int i, int sign)
+{
+    if (--(*n) == i)
+        return;
+    median_heap_set(h, where, i, h[*n], sign);
+    median_heap_up(key, h, where, i, sign);
+    median_heap_down(key, h, where, *n, (sign > 0 ? where[h[i]] : ~where[h[i]]), sign);
+}
+
+// Add one sample key, dropping the oldest one once the window is full. Afterwards the lower heap
+// holds ceil(filled / 2) slots, so its top is the (lower) median.
+static inline void median_window_push(void* state_ptr, int32_t k)
+{
+    median_window_state* state = (median_window_state*)state_ptr;
+    const int window = state->window;
+    int32_t* key = median_window_keys(state_ptr);
+    int32_t* low = key + window;
+    int32_t* high = low + window;
+    int32_t* where = high + window;
+    int n_low = state->n_low;
+    int n_high = state->n_high;
+    const int32_t slot = state->pos;
+
+    if (state->filled == window) {
+        const int32_t w = where[slot];
+        if (w >= 0)
+            median_heap_remove(key, low, where, &n_low, w, 1);
+        else
+            median_heap_remove(key, high, where, &n_high, ~w, -1);
     }
     else {
-        *output = (int32_t)(((int64_t)temp[count / 2 - 1] + temp[count / 2]) / 2);
+        state->filled++;
+    }
+
+    key[slot] = k;
+    if (n_low == 0 || k <= key[low[0]])
+        median_heap_push(key, low, where, &n_low, slot, 1);
+    else
+        median_heap_push(key, high, where, &n_high, slot, -1);
+
+    if (n_low > n_high + 1)
+        median_heap_push(key, high, where, &n_high, median_heap_pop(key, low, where, &n_low, 1), -1);
+    else if (n_high > n_low)
+        median_heap_push(key, low, where, &n_low, median_heap_pop(key, high, where, &n_high, -1), 1);
+
+    state->n_low = n_low;
+    state->n_high = n_high;
+    state->pos = slot + 1 == window ? 0 : slot + 1;
+}
+
+// Keys of the lower and upper middle samples (equal when the number of samples is odd).
+static inline void median_window_middle(void* state_ptr, int32_t* lower, int32_t* upper)
+{
+    median_window_state* state = (median_window_state*)state_ptr;
+    const int32_t* key = median_window_keys(state_ptr);
+    const int32_t* low = key + state->window;
+    const int32_t* high = low + state->window;
+    *lower = key[low[0]];
+    *upper = state->n_high == state->n_low ? key[high[0]] : *lower;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_window_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_window"
+
+// Order-preserving mapping between floats and int32 keys (not defined for NaN).
+static inline int32_t median_key_f32(float v)
+{
+    int32_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b >= 0 ? b : b ^ INT32_MAX;
+}
+
+static inline float median_value_f32(int32_t k)
+{
+    int32_t b = k >= 0 ? k : k ^ INT32_MAX;
+    float v;
+    memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+// output[i] is the median of the last 'window' samples up to and including input[i]
+// (of all samples so far while the window is filling up).
+static inline void median_window_f32(const float* restrict input, float* restrict output, int count, int8_t* restrict state_bytes)
+{
+    for (int i = 0; i < count; i++) {
+        median_window_push(state_bytes, median_key_f32(input[i]));
+        int32_t lower, upper;
+        median_window_middle(state_bytes, &lower, &upper);
+        output[i] = lower == upper ? median_value_f32(lower) : (median_value_f32(lower) + median_value_f32(upper)) * 0.5f;
+    }
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_window_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_window"
+
+static inline void median_window_i8(const int8_t* restrict input, int8_t* restrict output, int count, int8_t* restrict state_bytes)
+{
+    for (int i = 0; i < count; i++) {
+        median_window_push(state_bytes, input[i]);
+        int32_t lower, upper;
+        median_window_middle(state_bytes, &lower, &upper);
+        output[i] = (int8_t)((lower + upper) / 2);
     }
 }
 
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_window_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_window"
+
+static inline void median_window_i16(const int16_t* restrict input, int16_t* restrict output, int count, int8_t* restrict state_bytes)
+{
+    for (int i = 0; i < count; i++) {
+        median_window_push(state_bytes, input[i]);
+        int32_t lower, upper;
+        median_window_middle(state_bytes, &lower, &upper);
+        output[i] = (int16_t)((lower + upper) / 2);
+    }
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "median_window_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "median_window"
+
+static inline void median_window_i32(const int32_t* restrict input, int32_t* restrict output, int count, int8_t* restrict state_bytes)
+{
+    for (int i = 0; i < count; i++) {
+        median_window_push(state_bytes, input[i]);
+        int32_t lower, upper;
+        median_window_middle(state_bytes, &lower, &upper);
+        output[i] = (int32_t)(((int64_t)lower + upper) / 2);
+    }
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -3,43 +3,58 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "min_sparse_f32"
-
-static inline float __min_sparse_f32(const float* restrict input, int step, int size)
-{
-	float min_value = FLT_MAX;
-	for (int i = 0; i < size; i++) {
-		float value = *input;
-		if (value < min_value)
-			min_value = value;	
-		input += step;
-	}
-	return min_value;
-}
+#pragma IMAGINET_FRAGMENT_BEGIN "min_lanes"
+#define MIN_LANES 8
+#pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "min_sparse_f32"
+// Row-wise like max_sparse_f32 in Max/max.h.
 static inline void min_sparse_f32(const float* restrict input, int step, int size, int slot, float* restrict output)
 {
 	int d3 = step * size;
 
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __min_sparse_f32(input + i, step, size);
+			output[i] = FLT_MAX;
+		}
+		for (int j = 0; j < size; j++) {
+			const float* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] < output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
-
 #pragma IMAGINET_FRAGMENT_BEGIN "min_f32"
-
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "min_lanes"
+// Lane-wise like __max_f32 in Max/max.h.
 static inline float __min_f32(const float* restrict input, int size)
 {
-	float min_value = FLT_MAX;
-	for (int i = 0; i < size; i++) {
-		float value = *input++;
-		if (value < min_value)
-			min_value = value;
+	float lane[MIN_LANES];
+	for (int l = 0; l < MIN_LANES; l++) {
+		lane[l] = FLT_MAX;
+	}
+
+	int i = 0;
+	for (; i + MIN_LANES <= size; i += MIN_LANES) {
+		for (int l = 0; l < MIN_LANES; l++) {
+			const float value = input[i + l];
+			lane[l] = value < lane[l] ? value : lane[l];
+		}
+	}
+
+	float min_value = lane[0];
+	for (int l = 1; l < MIN_LANES; l++) {
+		if (lane[l] < min_value)
+			min_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] < min_value)
+			min_value = input[i];
 	}
 	return min_value;
 }
@@ -54,38 +69,51 @@ static inline void min_f32(const float* restrict input, int size, int slot, floa
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_sparse_i8"
-static inline int8_t __min_sparse_i8(const int8_t* restrict input, int step, int size)
-{
-	int8_t min_value = INT8_MAX;
-	for (int i = 0; i < size; i++) {
-		int8_t value = *input;
-		if (value < min_value)
-			min_value = value;
-		input += step;
-	}
-	return min_value;
-}
-
 static inline void min_sparse_i8(const int8_t* restrict input, int step, int size, int slot, int8_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __min_sparse_i8(input + i, step, size);
+			output[i] = INT8_MAX;
+		}
+		for (int j = 0; j < size; j++) {
+			const int8_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] < output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "min_lanes"
 static inline int8_t __min_i8(const int8_t* restrict input, int size)
 {
-	int8_t min_value = INT8_MAX;
-	for (int i = 0; i < size; i++) {
-		int8_t value = *input++;
-		if (value < min_value)
-			min_value = value;
+	int8_t lane[MIN_LANES];
+	for (int l = 0; l < MIN_LANES; l++) {
+		lane[l] = INT8_MAX;
+	}
+
+	int i = 0;
+	for (; i + MIN_LANES <= size; i += MIN_LANES) {
+		for (int l = 0; l < MIN_LANES; l++) {
+			const int8_t value = input[i + l];
+			lane[l] = value < lane[l] ? value : lane[l];
+		}
+	}
+
+	int8_t min_value = lane[0];
+	for (int l = 1; l < MIN_LANES; l++) {
+		if (lane[l] < min_value)
+			min_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] < min_value)
+			min_value = input[i];
 	}
 	return min_value;
 }
@@ -100,38 +128,51 @@ static inline void min_i8(const int8_t* restrict input, int size, int slot, int8
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_sparse_i16"
-static inline int16_t __min_sparse_i16(const int16_t* restrict input, int step, int size)
-{
-	int16_t min_value = INT16_MAX;
-	for (int i = 0; i < size; i++) {
-		int16_t value = *input;
-		if (value < min_value)
-			min_value = value;
-		input += step;
-	}
-	return min_value;
-}
-
 static inline void min_sparse_i16(const int16_t* restrict input, int step, int size, int slot, int16_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __min_sparse_i16(input + i, step, size);
+			output[i] = INT16_MAX;
+		}
+		for (int j = 0; j < size; j++) {
+			const int16_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] < output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "min_lanes"
 static inline int16_t __min_i16(const int16_t* restrict input, int size)
 {
-	int16_t min_value = INT16_MAX;
-	for (int i = 0; i < size; i++) {
-		int16_t value = *input++;
-		if (value < min_value)
-			min_value = value;
+	int16_t lane[MIN_LANES];
+	for (int l = 0; l < MIN_LANES; l++) {
+		lane[l] = INT16_MAX;
+	}
+
+	int i = 0;
+	for (; i + MIN_LANES <= size; i += MIN_LANES) {
+		for (int l = 0; l < MIN_LANES; l++) {
+			const int16_t value = input[i + l];
+			lane[l] = value < lane[l] ? value : lane[l];
+		}
+	}
+
+	int16_t min_value = lane[0];
+	for (int l = 1; l < MIN_LANES; l++) {
+		if (lane[l] < min_value)
+			min_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] < min_value)
+			min_value = input[i];
 	}
 	return min_value;
 }
@@ -146,38 +187,51 @@ static inline void min_i16(const int16_t* restrict input, int size, int slot, in
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_sparse_i32"
-static inline int32_t __min_sparse_i32(const int32_t* restrict input, int step, int size)
-{
-	int32_t min_value = INT32_MAX;
-	for (int i = 0; i < size; i++) {
-		int32_t value = *input;
-		if (value < min_value)
-			min_value = value;
-		input += step;
-	}
-	return min_value;
-}
-
 static inline void min_sparse_i32(const int32_t* restrict input, int step, int size, int slot, int32_t* restrict output)
 {
 	int d3 = step * size;
+
 	for (int k = 0; k < slot; k++) {
 		for (int i = 0; i < step; i++) {
-			*output++ = __min_sparse_i32(input + i, step, size);
+			output[i] = INT32_MAX;
+		}
+		for (int j = 0; j < size; j++) {
+			const int32_t* row = input + j * step;
+			for (int i = 0; i < step; i++) {
+				output[i] = row[i] < output[i] ? row[i] : output[i];
+			}
 		}
 		input += d3;
+		output += step;
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "min_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "min_lanes"
 static inline int32_t __min_i32(const int32_t* restrict input, int size)
 {
-	int32_t min_value = INT32_MAX;
-	for (int i = 0; i < size; i++) {
-		int32_t value = *input++;
-		if (value < min_value)
-			min_value = value;
+	int32_t lane[MIN_LANES];
+	for (int l = 0; l < MIN_LANES; l++) {
+		lane[l] = INT32_MAX;
+	}
+
+	int i = 0;
+	for (; i + MIN_LANES <= size; i += MIN_LANES) {
+		for (int l = 0; l < MIN_LANES; l++) {
+			const int32_t value = input[i + l];
+			lane[l] = value < lane[l] ? value : lane[l];
+		}
+	}
+
+	int32_t min_value = lane[0];
+	for (int l = 1; l < MIN_LANES; l++) {
+		if (lane[l] < min_value)
+			min_value = lane[l];
+	}
+	for (; i < size; i++) {
+		if (input[i] < min_value)
+			min_value = input[i];
 	}
 	return min_value;
 }
@@ -4,13 +4,21 @@
 
 // a.shape == output.shape
 #pragma IMAGINET_FRAGMENT_BEGIN "prod_f32"
-static inline float __prod_f32(const float* restrict input, int step, int count)
+static inline float __prod_f32(const float* restrict input, int count)
 {
-	float prod = 1;
-	for (int j = 0; j < count; j++) {
-		prod *= input[j * step];
+	// Four independent products along a contiguous axis.
+	float p0 = 1, p1 = 1, p2 = 1, p3 = 1;
+	int j = 0;
+	for (; j + 4 <= count; j += 4) {
+		p0 *= input[j];
+		p1 *= input[j + 1];
+		p2 *= input[j + 2];
+		p3 *= input[j + 3];
 	}
-	return prod;
+	for (; j < count; j++) {
+		p0 *= input[j];
+	}
+	return (p0 * p1) * (p2 * p3);
 }
 
 // a = input array (any shape >= 1D)
@@ -20,14 +28,28 @@ static inline float __prod_f32(const float* restrict input, int step, int count)
 // d0 = input.shape.step(axis)
 // d1 = input.shape.size(axis)
 // d2 = input.shape.slot(axis)
+// With d0 > 1 whole rows are multiplied element-wise into the outputs, so memory is read in order.
 static inline void prod_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
 {
 	int d3 = d0 * d1;
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
+		const float* x = input + k * d3;
+		float* out = output + k * d0;
+
+		if (d0 == 1) {
+			out[0] = __prod_f32(x, d1);
+			continue;
+		}
+
 		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __prod_f32(input + i + id, d0, d1);
+			out[i] = x[i];
+		}
+		for (int j = 1; j < d1; j++) {
+			const float* row = x + j * d0;
+			for (int i = 0; i < d0; i++) {
+				out[i] *= row[i];
+			}
 		}
 	}
 }
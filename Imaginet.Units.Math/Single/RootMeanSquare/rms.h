@@ -10,17 +10,22 @@ static inline void rms_f32(const float* restrict input, float* restrict rms_out,
     float temp_rms = 0;
     int temp_clip = 0;
     float x;
-    float y;
     float highest_value = 0;
 
-    // calculate the rms value & clipping
-    for (int i = 0; i < count; i++) {
-        x = (float)input[i];
-        y = x;
-
-        x = x * x;     // square value
-        temp_rms += x; // add values
+    // sum of squares, with four independent accumulators
+    float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        s0 += input[i] * input[i];
+        s1 += input[i + 1] * input[i + 1];
+        s2 += input[i + 2] * input[i + 2];
+        s3 += input[i + 3] * input[i + 3];
+    }
+    for (; i < count; i++) {
+        x = input[i];
+        s0 += x * x;
     }
+    temp_rms = (s0 + s1) + (s2 + s3);
     // compute the RMS value
     float rms_value = sqrt(temp_rms / count);
     // add a small threshold to avoid infinity or log(0) issues
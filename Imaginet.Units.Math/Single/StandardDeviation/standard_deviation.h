@@ -4,80 +4,93 @@
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "standard_deviation_f32"
-
-static inline float __standard_deviation_f32(const float* input, int step, int count)
-{
-	if (count <= 0) {
-		return 0.0f;
-	}
-
-	float sum = 0.0f;
-	for (int i = 0; i < count; i++) {
-		sum += input[i * step];
-	}
-	float mean = sum / (float)count;
-
-	float variance = 0.0f;
-	for (int i = 0; i < count; i++) {
-		float diff = input[i * step] - mean;
-		variance += diff * diff;
-	}
-	variance /= (float)count;
-
-	return sqrtf(variance);
-}
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Variance/variance.h:variance_welford_f32"
 
 // input array (any shape)
 // output array (input.shape.remove(axis))
 // d0 = input.shape.step(axis)
 // d1 = input.shape.size(axis)
 // d2 = input.shape.slot(axis)
+// Single pass over the input (see variance_axis_f32), followed by a square root per output.
 static inline void standard_deviation_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
 {
-	const int d3 = d0 * d1;
+	const int n = d0 * d2;
 
-	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __standard_deviation_f32(input + i + id, d0, d1);
+	if (d1 <= 0) {
+		for (int i = 0; i < n; i++) {
+			output[i] = 0.0f;
 		}
+		return;
+	}
+
+	variance_axis_f32(input, d0, d1, d2, output);
+	for (int i = 0; i < n; i++) {
+		output[i] = sqrtf(output[i]);
 	}
 }
 
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "standard_deviation_i8"
+#pragma IMAGINET_FRAGMENT_BEGIN "standard_deviation_int"
 
-static inline int8_t __standard_deviation_i8(const int8_t* input, int step, int count)
-{
-	if (count <= 0) {
-		return 0;
-	}
+#define STANDARD_DEVIATION_COLS 64
 
-	float sum = 0.0f;
-	for (int i = 0; i < count; i++) {
-		sum += (float)input[i * step];
+// Integer inputs are summed exactly (sum and sum of squares in int64) in a single pass, so there is
+// no rounding to guard against until the final subtraction, which is done in double.
+static inline float __standard_deviation_finish(int64_t sum, int64_t sum_sq, int count)
+{
+	const double mean = (double)sum / count;
+	double variance = ((double)sum_sq - (double)sum * mean) / count;
+	if (variance < 0.0) {
+		variance = 0.0;
 	}
-	float mean = sum / (float)count;
+	return sqrtf((float)variance);
+}
 
-	float variance = 0.0f;
-	for (int i = 0; i < count; i++) {
-		float diff = (float)input[i * step] - mean;
-		variance += diff * diff;
-	}
-	variance /= (float)count;
+#pragma IMAGINET_FRAGMENT_END
 
-	return (int8_t)sqrtf(variance);
-}
+#pragma IMAGINET_FRAGMENT_BEGIN "standard_deviation_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "standard_deviation_int"
 
 static inline void standard_deviation_i8(const int8_t* restrict input, int d0, int d1, int d2, int8_t* restrict output)
 {
-	const int d3 = d0 * d1;
+	if (d1 <= 0) {
+		for (int i = 0; i < d0 * d2; i++) {
+			output[i] = 0;
+		}
+		return;
+	}
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __standard_deviation_i8(input + i + id, d0, d1);
+		const int8_t* x = input + k * d0 * d1;
+		int8_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			int64_t sum = 0, sum_sq = 0;
+			for (int j = 0; j < d1; j++) {
+				const int32_t v = x[j];
+				sum += v;
+				sum_sq += v * v;
+			}
+			out[0] = (int8_t)__standard_deviation_finish(sum, sum_sq, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += STANDARD_DEVIATION_COLS) {
+			const int cols = d0 - c < STANDARD_DEVIATION_COLS ? d0 - c : STANDARD_DEVIATION_COLS;
+			int64_t sum[STANDARD_DEVIATION_COLS] = { 0 };
+			int64_t sum_sq[STANDARD_DEVIATION_COLS] = { 0 };
+			for (int j = 0; j < d1; j++) {
+				const int8_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int32_t v = row[i];
+					sum[i] += v;
+					sum_sq[i] += v * v;
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = (int8_t)__standard_deviation_finish(sum[i], sum_sq[i], d1);
+			}
 		}
 	}
 }
@@ -85,37 +98,47 @@ static inline void standard_deviation_i8(const int8_t* restrict input, int d0, i
 #pragma IMAGINET_FRAGMENT_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "standard_deviation_i16"
-
-static inline int16_t __standard_deviation_i16(const int16_t* input, int step, int count)
-{
-	if (count <= 0) {
-		return 0;
-	}
-
-	float sum = 0.0f;
-	for (int i = 0; i < count; i++) {
-		sum += (float)input[i * step];
-	}
-	float mean = sum / (float)count;
-
-	float variance = 0.0f;
-	for (int i = 0; i < count; i++) {
-		float diff = (float)input[i * step] - mean;
-		variance += diff * diff;
-	}
-	variance /= (float)count;
-
-	return (int16_t)sqrtf(variance);
-}
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "standard_deviation_int"
 
 static inline void standard_deviation_i16(const int16_t* restrict input, int d0, int d1, int d2, int16_t* restrict output)
 {
-	const int d3 = d0 * d1;
+	if (d1 <= 0) {
+		for (int i = 0; i < d0 * d2; i++) {
+			output[i] = 0;
+		}
+		return;
+	}
 
 	for (int k = 0; k < d2; k++) {
-		int id = k * d3;
-		for (int i = 0; i < d0; i++) {
-			output[i + k * d0] = __standard_deviation_i16(input + i + id, d0, d1);
+		const int16_t* x = input + k * d0 * d1;
+		int16_t* out = output + k * d0;
+
+		if (d0 == 1) {
+			int64_t sum = 0, sum_sq = 0;
+			for (int j = 0; j < d1; j++) {
+				const int32_t v = x[j];
+				sum += v;
+				sum_sq += v * v;
+			}
+			out[0] = (int16_t)__standard_deviation_finish(sum, sum_sq, d1);
+			continue;
+		}
+
+		for (int c = 0; c < d0; c += STANDARD_DEVIATION_COLS) {
+			const int cols = d0 - c < STANDARD_DEVIATION_COLS ? d0 - c : STANDARD_DEVIATION_COLS;
+			int64_t sum[STANDARD_DEVIATION_COLS] = { 0 };
+			int64_t sum_sq[STANDARD_DEVIATION_COLS] = { 0 };
+			for (int j = 0; j < d1; j++) {
+				const int16_t* row = x + j * d0 + c;
+				for (int i = 0; i < cols; i++) {
+					const int32_t v = row[i];
+					sum[i] += v;
+					sum_sq[i] += v * v;
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = (int16_t)__standard_deviation_finish(sum[i], sum_sq[i], d1);
+			}
 		}
 	}
 }
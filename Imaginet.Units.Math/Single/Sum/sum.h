@@ -2,100 +2,376 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "sum_f32"
+// All reductions below take the same two paths:
+//  - d0 == 1: the reduced axis is contiguous, each output is a reduction over adjacent elements.
+//  - d0 > 1:  adjacent elements belong to different outputs, so whole rows are accumulated
+//             element-wise into a block of outputs. The inner loop then runs over contiguous
+//             memory, instead of one strided column at a time.
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_lanes_f32"
+
+#define SUM_LANES 8
+
+// Sum of contiguous values with SUM_LANES independent accumulators. The additions of different
+// lanes do not wait on each other, so the loop runs at the throughput of the adder instead of
+// its latency. The rounding error still grows with count.
+static inline float __sum_lanes_f32(const float* restrict input, int count)
+{
+	if (count < SUM_LANES) {
+		float sum = 0.0f;
+		for (int j = 0; j < count; j++) {
+			sum += input[j];
+		}
+		return sum;
+	}
+
+	float r[SUM_LANES];
+	for (int l = 0; l < SUM_LANES; l++) {
+		r[l] = input[l];
+	}
+	int j = SUM_LANES;
+	for (; j + SUM_LANES <= count; j += SUM_LANES) {
+		for (int l = 0; l < SUM_LANES; l++) {
+			r[l] += input[j + l];
+		}
+	}
+	float sum = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));
+	for (; j < count; j++) {
+		sum += input[j];
+	}
+	return sum;
+}
+
+// output[i] = sum over rows j of input[j * step + i], for 0 <= i < step
+static inline void __sum_rows_f32(const float* restrict input, int step, int count, float* restrict output)
+{
+	for (int i = 0; i < step; i++) {
+		output[i] = input[i];
+	}
+	for (int j = 1; j < count; j++) {
+		const float* row = input + j * step;
+		for (int i = 0; i < step; i++) {
+			output[i] += row[i];
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_pairwise_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_lanes_f32"
+
+#define SUM_PAIRWISE_BLOCK 128
+#define SUM_PAIRWISE_COLS 64
+
+// Pairwise summation of contiguous values: blocks of up to SUM_PAIRWISE_BLOCK elements are
+// summed with independent accumulators, larger ranges are split in half. The rounding error
+// grows with log(count) instead of count.
+static inline float __sum_pairwise_f32(const float* restrict input, int count)
+{
+	if (count <= SUM_PAIRWISE_BLOCK) {
+		return __sum_lanes_f32(input, count);
+	}
+
+	const int half = (count / 2) & ~(SUM_LANES - 1);
+	return __sum_pairwise_f32(input, half) + __sum_pairwise_f32(input + half, count - half);
+}
 
-static inline float __sum_f32(const float* restrict input, int step, int count)
+// Pairwise summation of rows for up to SUM_PAIRWISE_COLS columns:
+// output[i] = sum over rows j of input[j * step + i], for 0 <= i < cols
+static inline void __sum_rows_pairwise_f32(const float* restrict input, int step, int count, int cols, float* restrict output)
 {
-	float sum = 0;
-	for (int j = 0; j < count; j++) {
-		sum += input[j * step];
+	if (count <= SUM_PAIRWISE_BLOCK) {
+		for (int i = 0; i < cols; i++) {
+			output[i] = input[i];
+		}
+		for (int j = 1; j < count; j++) {
+			const float* row = input + j * step;
+			for (int i = 0; i < cols; i++) {
+				output[i] += row[i];
+			}
+		}
+		return;
+	}
+
+	const int half = count / 2;
+	float upper[SUM_PAIRWISE_COLS];
+	__sum_rows_pairwise_f32(input, step, half, cols, output);
+	__sum_rows_pairwise_f32(input + half * step, step, count - half, cols, upper);
+	for (int i = 0; i < cols; i++) {
+		output[i] += upper[i];
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_compensated_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_lanes_f32"
+
+#define SUM_KAHAN_COLS 64
+
+// Kahan (compensated) summation: the low-order bits lost in every addition are kept in c and fed
+// back into the next one, so the error does not grow with count. Four operations per element
+// instead of one. Relies on the compiler not reassociating floating point (no -ffast-math).
+static inline void __sum_kahan_add_f32(float* sum, float* c, float value)
+{
+	const float y = value - *c;
+	const float t = *sum + y;
+	*c = (t - *sum) - y;
+	*sum = t;
+}
+
+// Contiguous values, SUM_LANES independent compensated accumulators
+static inline float __sum_kahan_f32(const float* restrict input, int count)
+{
+	float sum = 0.0f, c = 0.0f;
+	int j = 0;
+
+	if (count >= SUM_LANES) {
+		float s[SUM_LANES], e[SUM_LANES];
+		for (int l = 0; l < SUM_LANES; l++) {
+			s[l] = 0.0f;
+			e[l] = 0.0f;
+		}
+		for (; j + SUM_LANES <= count; j += SUM_LANES) {
+			for (int l = 0; l < SUM_LANES; l++) {
+				const float y = input[j + l] - e[l];
+				const float t = s[l] + y;
+				e[l] = (t - s[l]) - y;
+				s[l] = t;
+			}
+		}
+		for (int l = 0; l < SUM_LANES; l++) {
+			__sum_kahan_add_f32(&sum, &c, s[l]);
+			__sum_kahan_add_f32(&sum, &c, -e[l]);
+		}
+	}
+	for (; j < count; j++) {
+		__sum_kahan_add_f32(&sum, &c, input[j]);
 	}
 	return sum;
 }
 
+// output[i] = sum over rows j of input[j * step + i], for 0 <= i < step
+static inline void __sum_rows_kahan_f32(const float* restrict input, int step, int count, float* restrict output)
+{
+	for (int c = 0; c < step; c += SUM_KAHAN_COLS) {
+		const int cols = step - c < SUM_KAHAN_COLS ? step - c : SUM_KAHAN_COLS;
+		float s[SUM_KAHAN_COLS] = { 0 };
+		float e[SUM_KAHAN_COLS] = { 0 };
+		for (int j = 0; j < count; j++) {
+			const float* row = input + j * step + c;
+			for (int i = 0; i < cols; i++) {
+				const float y = row[i] - e[i];
+				const float t = s[i] + y;
+				e[i] = (t - s[i]) - y;
+				s[i] = t;
+			}
+		}
+		for (int i = 0; i < cols; i++) {
+			output[c + i] = s[i];
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
 // input array (any shape >= 2D)
 // output array (same shape as input array except with axis removed)
 // d0 = input.shape.step(axis)
 // d1 = input.shape.size(axis)
 // d2 = input.shape.slot(axis)
-static inline void sum_f32(const float* restrict input, const int step, const int size, const int slot, float* restrict output)
+// The float sums come in three precision levels, selected by the precision option of the unit:
+//  - sum_naive_f32:    independent accumulators, fastest, error grows with d1
+//  - sum_f32:          pairwise, error grows with log(d1) at almost the same speed
+//  - sum_kahan_f32:    compensated, error independent of d1, about four times the work
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_naive_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_lanes_f32"
+static inline void sum_naive_f32(const float* restrict input, const int step, const int size, const int slot, float* restrict output)
 {
 	const int full_step = step * size;
 
-	for (int j = 0; j < slot; j++) {
-		const int j3 = j * full_step;
-		const int j0 = j * step;
-		for (int i = 0; i < step; i++) {
-			output[i + j0] = __sum_f32(input + i + j3, step, size);
+	if (step == 1) {
+		for (int j = 0; j < slot; j++) {
+			output[j] = __sum_lanes_f32(input + j * full_step, size);
 		}
+		return;
+	}
+
+	for (int j = 0; j < slot; j++) {
+		__sum_rows_f32(input + j * full_step, step, size, output + j * step);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "sum_i8"
-static inline int8_t __sum_i8(const int8_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_pairwise_f32"
+static inline void sum_f32(const float* restrict input, const int step, const int size, const int slot, float* restrict output)
 {
-	int32_t sum = 0;
-	for (int j = 0; j < count; j++) {
-		sum += input[j * step];
+	const int full_step = step * size;
+
+	if (step == 1) {
+		for (int j = 0; j < slot; j++) {
+			output[j] = __sum_pairwise_f32(input + j * full_step, size);
+		}
+		return;
+	}
+
+	for (int j = 0; j < slot; j++) {
+		for (int c = 0; c < step; c += SUM_PAIRWISE_COLS) {
+			const int cols = step - c < SUM_PAIRWISE_COLS ? step - c : SUM_PAIRWISE_COLS;
+			__sum_rows_pairwise_f32(input + j * full_step + c, step, size, cols, output + j * step + c);
+		}
 	}
-	return (int8_t)sum;
 }
+#pragma IMAGINET_FRAGMENT_END
 
-static inline void sum_i8(const int8_t* restrict input, const int step, const int size, const int slot, int8_t* restrict output)
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_kahan_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_compensated_f32"
+static inline void sum_kahan_f32(const float* restrict input, const int step, const int size, const int slot, float* restrict output)
 {
 	const int full_step = step * size;
-	for (int j = 0; j < slot; j++) {
-		const int j3 = j * full_step;
-		const int j0 = j * step;
-		for (int i = 0; i < step; i++) {
-			output[i + j0] = __sum_i8(input + i + j3, step, size);
+
+	if (step == 1) {
+		for (int j = 0; j < slot; j++) {
+			output[j] = __sum_kahan_f32(input + j * full_step, size);
 		}
+		return;
+	}
+
+	for (int j = 0; j < slot; j++) {
+		__sum_rows_kahan_f32(input + j * full_step, step, size, output + j * step);
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "sum_i16"
-static inline int16_t __sum_i16(const int16_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_int"
+#define SUM_COLS 64
+
+// The integer sums are exact in the wider accumulator and saturate to the output type when written.
+static inline int8_t __sum_sat_i8(int32_t sum)
 {
-	int32_t sum = 0;
-	for (int j = 0; j < count; j++) {
-		sum += input[j * step];
-	}
+	sum = sum > INT8_MAX ? INT8_MAX : sum;
+	sum = sum < INT8_MIN ? INT8_MIN : sum;
+	return (int8_t)sum;
+}
+
+static inline int16_t __sum_sat_i16(int32_t sum)
+{
+	sum = sum > INT16_MAX ? INT16_MAX : sum;
+	sum = sum < INT16_MIN ? INT16_MIN : sum;
 	return (int16_t)sum;
 }
 
-static inline void sum_i16(const int16_t* restrict input, const int step, const int size, const int slot, int16_t* restrict output)
+static inline int32_t __sum_sat_i32(int64_t sum)
+{
+	sum = sum > INT32_MAX ? INT32_MAX : sum;
+	sum = sum < INT32_MIN ? INT32_MIN : sum;
+	return (int32_t)sum;
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_i8"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_int"
+static inline void sum_i8(const int8_t* restrict input, const int step, const int size, const int slot, int8_t* restrict output)
 {
 	const int full_step = step * size;
 	for (int j = 0; j < slot; j++) {
-		const int j3 = j * full_step;
-		const int j0 = j * step;
-		for (int i = 0; i < step; i++) {
-			output[i + j0] = __sum_i16(input + i + j3, step, size);
+		const int8_t* x = input + j * full_step;
+		int8_t* out = output + j * step;
+
+		if (step == 1) {
+			int32_t sum = 0;
+			for (int r = 0; r < size; r++) {
+				sum += x[r];
+			}
+			out[0] = __sum_sat_i8(sum);
+			continue;
+		}
+
+		for (int c = 0; c < step; c += SUM_COLS) {
+			const int cols = step - c < SUM_COLS ? step - c : SUM_COLS;
+			int32_t acc[SUM_COLS] = { 0 };
+			for (int r = 0; r < size; r++) {
+				const int8_t* row = x + r * step + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = __sum_sat_i8(acc[i]);
+			}
 		}
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "sum_i32"
-static inline int32_t __sum_i32(const int32_t* restrict input, int step, int count)
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_i16"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_int"
+static inline void sum_i16(const int16_t* restrict input, const int step, const int size, const int slot, int16_t* restrict output)
 {
-	int64_t sum = 0;
-	for (int j = 0; j < count; j++) {
-		sum += input[j * step];
+	const int full_step = step * size;
+	for (int j = 0; j < slot; j++) {
+		const int16_t* x = input + j * full_step;
+		int16_t* out = output + j * step;
+
+		if (step == 1) {
+			int32_t sum = 0;
+			for (int r = 0; r < size; r++) {
+				sum += x[r];
+			}
+			out[0] = __sum_sat_i16(sum);
+			continue;
+		}
+
+		for (int c = 0; c < step; c += SUM_COLS) {
+			const int cols = step - c < SUM_COLS ? step - c : SUM_COLS;
+			int32_t acc[SUM_COLS] = { 0 };
+			for (int r = 0; r < size; r++) {
+				const int16_t* row = x + r * step + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = __sum_sat_i16(acc[i]);
+			}
+		}
 	}
-	return (int32_t)sum;
 }
+#pragma IMAGINET_FRAGMENT_END
 
+#pragma IMAGINET_FRAGMENT_BEGIN "sum_i32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "sum_int"
 static inline void sum_i32(const int32_t* restrict input, const int step, const int size, const int slot, int32_t* restrict output)
 {
 	const int full_step = step * size;
 	for (int j = 0; j < slot; j++) {
-		const int j3 = j * full_step;
-		const int j0 = j * step;
-		for (int i = 0; i < step; i++) {
-			output[i + j0] = __sum_i32(input + i + j3, step, size);
+		const int32_t* x = input + j * full_step;
+		int32_t* out = output + j * step;
+
+		if (step == 1) {
+			int64_t sum = 0;
+			for (int r = 0; r < size; r++) {
+				sum += x[r];
+			}
+			out[0] = __sum_sat_i32(sum);
+			continue;
+		}
+
+		for (int c = 0; c < step; c += SUM_COLS) {
+			const int cols = step - c < SUM_COLS ? step - c : SUM_COLS;
+			int64_t acc[SUM_COLS] = { 0 };
+			for (int r = 0; r < size; r++) {
+				const int32_t* row = x + r * step + c;
+				for (int i = 0; i < cols; i++) {
+					acc[i] += row[i];
+				}
+			}
+			for (int i = 0; i < cols; i++) {
+				out[c + i] = __sum_sat_i32(acc[i]);
+			}
 		}
 	}
 }
@@ -5,7 +5,13 @@ import numpy as np
 #pragma IMAGINET_FRAGMENT_BEGIN "sum"
 
 def sum(input, axis, output):
-    np.sum(input, axis=-axis-1, out=output)
+    if np.issubdtype(output.dtype, np.integer):
+        # Exact in int64, saturated to the output type like the C fragments
+        info = np.iinfo(output.dtype)
+        result = np.sum(input, axis=-axis-1, dtype=np.int64)
+        np.copyto(output, np.reshape(np.clip(result, info.min, info.max), output.shape), casting='unsafe')
+    else:
+        np.sum(input, axis=-axis-1, out=output)
 
 #pragma IMAGINET_FRAGMENT_END
 
@@ -2,32 +2,142 @@
 #include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "variance_f32"
+#pragma IMAGINET_FRAGMENT_BEGIN "variance_welford_f32"
+
+#define VARIANCE_BLOCK 64    // Values reduced per block along a contiguous axis
+#define VARIANCE_COLS 64     // Columns updated together when the axis is not contiguous
 
-static inline void variance_f32(const float* restrict input, float* restrict output, int count)
+// Mean and sum of squared deviations (M2) of 'count' contiguous values in one pass over memory.
+// Each block of VARIANCE_BLOCK values is reduced twice while it is in cache (mean, then squared
+// deviations from the block mean) and merged into the running result with Chan's update, so the
+// large-mean cancellation of sum(x^2) - n * mean^2 never occurs. Four accumulators per loop
+// keep the additions independent.
+static inline void __variance_contiguous_f32(const float* restrict input, int count, float* mean_out, float* m2_out)
 {
-    if (count <= 0) {
-        *output = 0.0f;
-        return;
+    float mean = 0.0f;
+    float m2 = 0.0f;
+    int n = 0;
+
+    for (int b = 0; b < count; b += VARIANCE_BLOCK) {
+        const float* x = input + b;
+        const int len = count - b < VARIANCE_BLOCK ? count - b : VARIANCE_BLOCK;
+
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int k = 0;
+        for (; k + 4 <= len; k += 4) {
+            s0 += x[k];
+            s1 += x[k + 1];
+            s2 += x[k + 2];
+            s3 += x[k + 3];
+        }
+        for (; k < len; k++) {
+            s0 += x[k];
+        }
+        const float block_mean = ((s0 + s1) + (s2 + s3)) / (float)len;
+
+        float q0 = 0.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+        k = 0;
+        for (; k + 4 <= len; k += 4) {
+            const float e0 = x[k] - block_mean;
+            const float e1 = x[k + 1] - block_mean;
+            const float e2 = x[k + 2] - block_mean;
+            const float e3 = x[k + 3] - block_mean;
+            q0 += e0 * e0;
+            q1 += e1 * e1;
+            q2 += e2 * e2;
+            q3 += e3 * e3;
+        }
+        for (; k < len; k++) {
+            const float e = x[k] - block_mean;
+            q0 += e * e;
+        }
+        const float block_m2 = (q0 + q1) + (q2 + q3);
+
+        const int total = n + len;
+        const float delta = block_mean - mean;
+        mean += delta * ((float)len / (float)total);
+        m2 += block_m2 + delta * delta * ((float)n * (float)len / (float)total);
+        n = total;
+    }
+
+    *mean_out = mean;
+    *m2_out = m2;
+}
+
+// Welford's update for 'cols' adjacent columns whose rows are 'step' elements apart.
+// Every row is read contiguously and the columns do not depend on each other, so the inner loop
+// vectorizes; the reciprocal of the running count is shared by all columns of a row.
+static inline void __variance_columns_f32(const float* restrict input, int step, int count, int cols,
+    float* restrict mean, float* restrict m2)
+{
+    for (int i = 0; i < cols; i++) {
+        mean[i] = input[i];
+        m2[i] = 0.0f;
+    }
+
+    for (int r = 1; r < count; r++) {
+        const float* x = input + r * step;
+        const float inv = 1.0f / (float)(r + 1);
+        for (int i = 0; i < cols; i++) {
+            const float delta = x[i] - mean[i];
+            mean[i] += delta * inv;
+            m2[i] += delta * (x[i] - mean[i]);
+        }
     }
-    
-    // Calculate mean
-    float sum = 0.0f;
-    for (int i = 0; i < count; i++) {
-        sum += input[i];
+}
+
+// Population variance along an axis.
+// input array (any shape)
+// output array (input.shape.remove(axis))
+// d0 = input.shape.step(axis)
+// d1 = input.shape.size(axis)
+// d2 = input.shape.slot(axis)
+static inline void variance_axis_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
+{
+    const float inv_count = 1.0f / (float)d1;
+
+    for (int k = 0; k < d2; k++) {
+        const float* x = input + k * d0 * d1;
+        float* out = output + k * d0;
+
+        if (d0 == 1) {
+            float mean, m2;
+            __variance_contiguous_f32(x, d1, &mean, &m2);
+            out[0] = m2 * inv_count;
+            continue;
+        }
+
+        for (int c = 0; c < d0; c += VARIANCE_COLS) {
+            const int cols = d0 - c < VARIANCE_COLS ? d0 - c : VARIANCE_COLS;
+            float mean[VARIANCE_COLS];
+            __variance_columns_f32(x + c, d0, d1, cols, mean, out + c);
+            for (int i = 0; i < cols; i++) {
+                out[c + i] *= inv_count;
+            }
+        }
     }
-    float mean = sum / count;
-    
-    // Calculate variance
-    float variance = 0.0f;
-    for (int i = 0; i < count; i++) {
-        float diff = input[i] - mean;
-        variance += diff * diff;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "variance_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "variance_welford_f32"
+
+// input array (any shape)
+// output array (input.shape.remove(axis))
+// d0 = input.shape.step(axis)
+// d1 = input.shape.size(axis)
+// d2 = input.shape.slot(axis)
+static inline void variance_f32(const float* restrict input, int d0, int d1, int d2, float* restrict output)
+{
+    if (d1 <= 0) {
+        for (int i = 0; i < d0 * d2; i++) {
+            output[i] = 0.0f;
+        }
+        return;
     }
-    variance /= count;
-    
-    // Standard deviation is square root of variance
-    *output = variance;
+
+    variance_axis_f32(input, d0, d1, d2, output);
 }
 
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
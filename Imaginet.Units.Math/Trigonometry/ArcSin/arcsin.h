@@ -28,4 +28,24 @@ static inline void arcsin_u8(const uint8_t* restrict x, int count, uint8_t* rest
 		output[i] = asin(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "arcsin_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sin/sin.h:trig_fast"
+
+// Polynomial arcsine. For |x| > 0.5 it uses asin(x) = pi/2 - 2 * asin(sqrt((1 - |x|) / 2)).
+// Max error 2.5 ulp on [-1, 1], NaN outside. Only the sqrtf keeps this loop scalar unless
+// errno reporting is disabled (-fno-math-errno).
+static inline void arcsin_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		const float a = fabsf(x[i]);
+		const uint32_t big = 0u - (uint32_t)(a > 0.5f);
+		const float z = __trig_select_f32(big, 0.5f * (1.0f - a), a * a);
+		const float s = __trig_select_f32(big, sqrtf(z), a);
+		const float p = s + s * z * ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z
+			+ 7.4953002686e-2f) * z + 1.6666752422e-1f);
+		output[i] = copysignf(__trig_select_f32(big, 1.5707963267948966f - 2.0f * p, p), x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
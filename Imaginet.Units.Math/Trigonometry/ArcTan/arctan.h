@@ -28,4 +28,25 @@ static inline void arctan_u8(const uint8_t* restrict x, int count, uint8_t* rest
 		output[i] = atan(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "arctan_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sin/sin.h:trig_fast"
+
+// Polynomial arctangent. |x| is reduced to [0, tan(pi/8)] with atan(x) = pi/2 + atan(-1/x) and
+// atan(x) = pi/4 + atan((x - 1) / (x + 1)); both reductions are computed and the result selected.
+// Max error 3 ulp over the whole float range.
+static inline void arctan_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		const float a = fabsf(x[i]);
+		const uint32_t big = 0u - (uint32_t)(a > 2.414213562373095f);
+		const uint32_t mid = 0u - (uint32_t)(a > 0.4142135623730950f);
+		const float t = __trig_select_f32(big, -1.0f / a, __trig_select_f32(mid, (a - 1.0f) / (a + 1.0f), a));
+		const float base = __trig_select_f32(big, 1.5707963267948966f, __trig_select_f32(mid, 0.7853981633974483f, 0.0f));
+		const float z = t * t;
+		const float y = base + t + t * z * (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f);
+		output[i] = copysignf(y, x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -28,4 +28,26 @@ static inline void cos_u8(const uint8_t* restrict x, int count, uint8_t* restric
 		output[i] = cos(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "cos_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sin/sin.h:trig_fast"
+
+// Polynomial cosine, sharing the range reduction of sin_fast_f32.
+// Max error 2.5 ulp for |x| <= 8192. Larger arguments, infinities and NaN are computed by cosf.
+static inline void cos_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		uint32_t q;
+		const float r = __trig_reduce_f32(x[i], &q);
+		const float z = r * r;
+		const float s = __trig_sin_poly_f32(r, z);
+		const float c = __trig_cos_poly_f32(z);
+		output[i] = __trig_flip_sign_f32(__trig_select_f32(0u - (q & 1), s, c), (q + 1) >> 1);
+	}
+	for (int i = 0; i < count; i++) {
+		if (!(fabsf(x[i]) <= TRIG_FAST_MAX))
+			output[i] = cosf(x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
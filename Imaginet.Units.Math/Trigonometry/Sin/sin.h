@@ -1,6 +1,7 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "sin_f32"
@@ -28,4 +29,92 @@ static inline void sin_u8(const uint8_t* restrict x, int count, uint8_t* restric
 		output[i] = sin(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "trig_select"
+
+// mask ? a : b on the bit patterns. A float select would be turned into a branch, which keeps
+// the loops from vectorizing. Also used by the Pow kernels.
+static inline float __trig_select_f32(uint32_t mask, float a, float b)
+{
+	uint32_t ua, ub;
+	memcpy(&ua, &a, sizeof(ua));
+	memcpy(&ub, &b, sizeof(ub));
+	ub ^= (ua ^ ub) & mask;
+	memcpy(&b, &ub, sizeof(b));
+	return b;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "trig_fast"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "trig_select"
+
+#define TRIG_FAST_ROUND 12582912.0f    // 1.5 * 2^23, adding it rounds a float to an integer
+#define TRIG_FAST_MAX 8192.0f          // largest |x| that __trig_reduce_f32 reduces accurately
+
+// Negates v when the lowest bit of flip is set.
+static inline float __trig_flip_sign_f32(float v, uint32_t flip)
+{
+	uint32_t bits;
+	memcpy(&bits, &v, sizeof(bits));
+	bits ^= flip << 31;
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+// Reduces x to r in [-pi/4, pi/4] with x = q * pi/2 + r. The low bits of *quadrant are q mod 4.
+// pi/2 is split into four parts, the first three with 11 significant bits, so the products with
+// q are exact for |x| <= TRIG_FAST_MAX and the reduction stays accurate near the zeros of sin and
+// cos. Beyond that the result is meaningless; callers pass those arguments to libm instead.
+static inline float __trig_reduce_f32(float x, uint32_t* quadrant)
+{
+	const float j = x * 0.63661977236758134f + TRIG_FAST_ROUND;
+	const float q = j - TRIG_FAST_ROUND;
+	memcpy(quadrant, &j, sizeof(*quadrant));
+
+	float r = x - q * 1.5703125f;
+	r = r - q * 4.837512969970703125e-4f;
+	r = r - q * 7.549533620476723e-8f;
+	r = r - q * 2.5633440682570896e-12f;
+	return r;
+}
+
+// Minimax polynomials for sin(r) and cos(r) on [-pi/4, pi/4], z = r * r
+static inline float __trig_sin_poly_f32(float r, float z)
+{
+	return r + r * z * ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+}
+
+static inline float __trig_cos_poly_f32(float z)
+{
+	return 1.0f - 0.5f * z + z * z * ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sin_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "trig_fast"
+
+// Polynomial sine without libm calls. The loop is branch-free and vectorizes.
+// Max error 2.5 ulp for |x| <= 8192. Larger arguments, infinities and NaN are computed by sinf
+// in a second pass, which only costs a compare for inputs in range. The polynomial turns -0 into
+// +0, so zeros are passed through there as well.
+static inline void sin_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		uint32_t q;
+		const float r = __trig_reduce_f32(x[i], &q);
+		const float z = r * r;
+		const float s = __trig_sin_poly_f32(r, z);
+		const float c = __trig_cos_poly_f32(z);
+		output[i] = __trig_flip_sign_f32(__trig_select_f32(0u - (q & 1), c, s), q >> 1);
+	}
+	for (int i = 0; i < count; i++) {
+		if (x[i] == 0.0f)
+			output[i] = x[i];
+		else if (!(fabsf(x[i]) <= TRIG_FAST_MAX))
+			output[i] = sinf(x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -1,6 +1,7 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <stdint.h>
 #include <math.h>
+#include <string.h>
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "sinh_f32"
@@ -28,4 +29,52 @@ static inline void sinh_u8(const uint8_t* restrict x, int count, uint8_t* restri
 		output[i] = sinh(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "exp_fast"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sin/sin.h:trig_fast"
+
+// e^x / 8 for x <= 89.7 (clamped above that and below -85.2). x = n * ln2 + r, e^r from a degree 6
+// polynomial and 2^(n - 3) built in the exponent bits. The division by 8 leaves room for the
+// largest arguments whose sinh and tanh intermediate results are still finite.
+static inline float __exp_scaled_f32(float x)
+{
+	x = __trig_select_f32(0u - (uint32_t)(x > 89.7f), 89.7f, x);
+	x = __trig_select_f32(0u - (uint32_t)(x < -85.2f), -85.2f, x);
+
+	const float j = x * 1.44269504088896341f + TRIG_FAST_ROUND;
+	const float n = j - TRIG_FAST_ROUND;
+	uint32_t bits;
+	memcpy(&bits, &j, sizeof(bits));
+
+	float r = x - n * 0.693359375f;
+	r = r + n * 2.12194440e-4f;
+	const float p = 1.0f + r + r * r * (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r
+		+ 4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f);
+
+	// The low bits of j hold n, so this is (n - 3 + 127) << 23
+	const uint32_t scale_bits = (bits + 124u) << 23;
+	float scale;
+	memcpy(&scale, &scale_bits, sizeof(scale));
+	return p * scale;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "sinh_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "exp_fast"
+
+// Polynomial sinh for |x| <= 1, (e^|x| - e^-|x|) / 2 above. Max error 2 ulp over the whole float
+// range, overflowing to infinity where sinh does.
+static inline void sinh_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		const float a = fabsf(x[i]);
+		const float z = a * a;
+		const float small = a + a * z * ((2.03721912945e-4f * z + 8.33028376239e-3f) * z + 1.66667160211e-1f);
+		const float h = 4.0f * __exp_scaled_f32(a);
+		const float large = h - 0.25f / h;
+		output[i] = copysignf(__trig_select_f32(0u - (uint32_t)(a > 1.0f), large, small), x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
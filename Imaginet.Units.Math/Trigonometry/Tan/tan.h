@@ -28,4 +28,26 @@ static inline void tan_u8(const uint8_t* restrict x, int count, uint8_t* restric
 		output[i] = tan(x[i]);
 	}
 }
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "tan_fast_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Sin/sin.h:trig_fast"
+
+// Polynomial tangent on the reduced argument of sin_fast_f32; odd quadrants use -1 / tan(r).
+// Max error 3.5 ulp for |x| <= 8192. Larger arguments, infinities and NaN are computed by tanf.
+static inline void tan_fast_f32(const float* restrict x, int count, float* restrict output)
+{
+	for (int i = 0; i < count; i++) {
+		uint32_t q;
+		const float r = __trig_reduce_f32(x[i], &q);
+		const float z = r * r;
+		const float t = r + r * z * (((((9.38540185543e-3f * z + 3.11992232697e-3f) * z + 2.44301354525e-2f) * z
+			+ 5.34112807005e-2f) * z + 1.33387994085e-1f) * z + 3.33331568548e-1f);
+		output[i] = __trig_select_f32(0u - (q & 1), -1.0f / t, t);
+	}
+	for (int i = 0; i < count; i++) {
+		if (!(fabsf(x[i]) <= TRIG_FAST_MAX))
+			output[i] = tanf(x[i]);
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,93 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "audio_augmentation_batch_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Reverb/reverb.h:reverb_state_t"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Reverb/reverb.h:reverb_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../../TemporalAnalysis/Delay/delay.h:delay_state_t"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../../TemporalAnalysis/Delay/delay.h:delay_f32"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Per-clip parameters, one row of AUDIO_AUGMENTATION_PARAMS floats per clip.
+#define AUDIO_AUGMENTATION_GAIN_DB 0
+#define AUDIO_AUGMENTATION_DISTANCE 1
+#define AUDIO_AUGMENTATION_ROOM_SIZE 2
+#define AUDIO_AUGMENTATION_DAMPING 3
+#define AUDIO_AUGMENTATION_WET 4
+#define AUDIO_AUGMENTATION_DRY 5
+#define AUDIO_AUGMENTATION_PARAMS 6
+
+// Upper limit of the wet and dry levels, as for the AudioAugmentation options.
+#define AUDIO_AUGMENTATION_MAX_LEVEL 10.0f
+
+static inline float __audio_augmentation_clamp(float value, float low, float high)
+{
+	value = value < low ? low : value;
+	return value > high ? high : value;
+}
+
+// Run the AudioAugmentation chain (Gain -> SoftClip -> DistanceAttenuation -> Reverb) over a
+// batch of independent mono clips, input[clips][samples], with one parameter row per clip.
+// The handle is a state arena for a single clip:
+//   delay_state_t + float delay[max_delay]
+//   reverb_state_t + float reverb[4 + c0 + c1 + c2 + c3 + a0 + a1]
+// It is cleared before every clip, so no clip depends on another; a host can split a batch
+// over several workers, each with its own arena, and get identical results.
+// The parameters are runtime data and are clamped to the option ranges of AudioAugmentation:
+// distance to [ref_distance, max_distance], room size and damping to [0, 1], wet and dry levels
+// to [0, 10]. Out of range room size or damping would make the comb filters diverge.
+static inline void audio_augmentation_batch_f32(const float* restrict input, const float* restrict params,
+	int8_t* restrict arena, float* restrict output, int clips, int samples, float sample_rate,
+	float ref_distance, float max_distance, float speed_of_sound, float base_cutoff, float absorption_rate,
+	int max_delay, int c0, int c1, int c2, int c3, int a0, int a1)
+{
+	const size_t delay_bytes = sizeof(delay_state_t) + (size_t)max_delay * sizeof(float);
+	const size_t reverb_bytes = sizeof(reverb_state_t) + (size_t)(4 + c0 + c1 + c2 + c3 + a0 + a1) * sizeof(float);
+	int8_t* delay_state = arena;
+	int8_t* reverb_state = arena + delay_bytes;
+
+	for (int c = 0; c < clips; c++) {
+		const float* p = params + c * AUDIO_AUGMENTATION_PARAMS;
+		const float* x = input + (size_t)c * samples;
+		float* y = output + (size_t)c * samples;
+
+		const float distance = __audio_augmentation_clamp(p[AUDIO_AUGMENTATION_DISTANCE], ref_distance, max_distance);
+
+		// Gain, then the inverse-distance law of DistanceAttenuation
+		const float gain = powf(10.0f, p[AUDIO_AUGMENTATION_GAIN_DB] / 20.0f);
+		const float distance_gain = ref_distance / distance;
+
+		// Air absorption low-pass, same alpha as lowpass_filter_init_f32
+		const float cutoff = base_cutoff / expf(absorption_rate * distance);
+		const float alpha = 1.0f - expf(-2.0f * (float)M_PI * cutoff / sample_rate);
+
+		int delay_samples = (int)roundf(distance / speed_of_sound * sample_rate);
+		if (delay_samples < 1)
+			delay_samples = 1;
+		if (delay_samples > max_delay)
+			delay_samples = max_delay;
+
+		const float feedback = __audio_augmentation_clamp(p[AUDIO_AUGMENTATION_ROOM_SIZE], 0.0f, 1.0f) * 0.28f + 0.7f;
+		const float damp1 = __audio_augmentation_clamp(p[AUDIO_AUGMENTATION_DAMPING], 0.0f, 1.0f);
+		const float wet = __audio_augmentation_clamp(p[AUDIO_AUGMENTATION_WET], 0.0f, AUDIO_AUGMENTATION_MAX_LEVEL);
+		const float dry = __audio_augmentation_clamp(p[AUDIO_AUGMENTATION_DRY], 0.0f, AUDIO_AUGMENTATION_MAX_LEVEL);
+
+		memset(arena, 0, delay_bytes + reverb_bytes);
+		float lp = 0.0f;
+
+		for (int i = 0; i < samples; i++) {
+			float v = tanhf(x[i] * gain) * distance_gain;
+			lp = alpha * v + (1.0f - alpha) * lp;
+			delay_f32(&lp, delay_state, &v, 1, delay_samples);
+			reverb_f32(&v, reverb_state, &y[i], 1, c0, c1, c2, c3, a0, a1, feedback, damp1, wet, dry);
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
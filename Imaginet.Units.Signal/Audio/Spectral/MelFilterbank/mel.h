@@ -1,5 +1,7 @@
 ﻿#pragma IMAGINET_INCLUDES_BEGIN
 #include <float.h>
+#include <math.h>
+#include <stdint.h>
 #pragma IMAGINET_INCLUDES_END
 
 #pragma IMAGINET_FRAGMENT_BEGIN "mel_f32"
@@ -42,3 +44,54 @@ static inline void mel_f32(const float* restrict input, const short* restrict fi
 	}
 }
 #pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "mel_f32_to_q7"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "mel_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "[Imaginet.Units.Math.Quantize]/quantize_q.h:quantize_q_sat"
+
+// mel_f32 written directly as Q7 with the given shift, without a float output tensor.
+static inline void mel_f32_to_q7(const float* restrict input, const short* restrict filter_points, int size, int slot, int num_filter, int shift, int8_t* restrict output)
+{
+	const float factor = ldexpf(128.0f, -shift);
+	for (int k = 0; k < slot; k++) {
+		const float *ip = input + k * size;
+		for (int i = 0; i < num_filter; i++) {
+			*output++ = __quantize_sat_q7(__mel_f32(ip, filter_points, i) * factor);
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "mel_f32_to_q15"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "mel_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "[Imaginet.Units.Math.Quantize]/quantize_q.h:quantize_q_sat"
+
+// mel_f32 written directly as Q15 with the given shift, without a float output tensor.
+static inline void mel_f32_to_q15(const float* restrict input, const short* restrict filter_points, int size, int slot, int num_filter, int shift, int16_t* restrict output)
+{
+	const float factor = ldexpf(32768.0f, -shift);
+	for (int k = 0; k < slot; k++) {
+		const float *ip = input + k * size;
+		for (int i = 0; i < num_filter; i++) {
+			*output++ = __quantize_sat_q15(__mel_f32(ip, filter_points, i) * factor);
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "mel_f32_to_q31"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "mel_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "[Imaginet.Units.Math.Quantize]/quantize_q.h:quantize_q_sat"
+
+// mel_f32 written directly as Q31 with the given shift, without a float output tensor.
+static inline void mel_f32_to_q31(const float* restrict input, const short* restrict filter_points, int size, int slot, int num_filter, int shift, int32_t* restrict output)
+{
+	const float factor = ldexpf(2147483648.0f, -shift);
+	for (int k = 0; k < slot; k++) {
+		const float *ip = input + k * size;
+		for (int i = 0; i < num_filter; i++) {
+			*output++ = __quantize_sat_q31(__mel_f32(ip, filter_points, i) * factor);
+		}
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
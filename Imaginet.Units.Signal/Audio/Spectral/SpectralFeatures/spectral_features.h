@@ -0,0 +1,165 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "spectral_features_state"
+
+// Descriptors written per spectrum, in this order along the output's innermost axis.
+#define SPECTRAL_CENTROID 0
+#define SPECTRAL_BANDWIDTH 1
+#define SPECTRAL_ROLLOFF 2
+#define SPECTRAL_FLATNESS 3
+#define SPECTRAL_FLUX 4
+#define SPECTRAL_FEATURES 5
+
+// Power floor used by the flatness measure, as in librosa.feature.spectral_flatness.
+#define SPECTRAL_AMIN 1e-10f
+
+// Handle layout (size = 16 + 2 * count * bins * 4 [+ bins * 2 for Q15 input] bytes):
+//   spectral_features_state header
+//   float mag[2][count][bins]  magnitude spectra of the current and previous call;
+//                              the buffers swap roles every call, so the current spectra are
+//                              never copied to become the previous ones
+//   q15_t staging[bins]        Q15 input only: fixed-point magnitudes before conversion
+typedef struct {
+	int32_t bins;
+	int32_t count;
+	int32_t current;	// Index of the buffer that receives the next spectra, 0 or 1
+	int32_t primed;		// Non-zero once a previous spectrum exists for the flux
+} spectral_features_state;
+
+static inline float* spectral_features_mags(void* state_ptr, int buffer)
+{
+	spectral_features_state* state = (spectral_features_state*)state_ptr;
+	return (float*)((char*)state_ptr + sizeof(spectral_features_state)) + (size_t)buffer * state->count * state->bins;
+}
+
+static inline void* spectral_features_staging(void* state_ptr)
+{
+	return spectral_features_mags(state_ptr, 2);
+}
+
+static inline int spectral_features_init(int8_t* restrict state_bytes, int bins, int count)
+{
+	spectral_features_state* state = (spectral_features_state*)state_bytes;
+	state->bins = bins;
+	state->count = count;
+	state->current = 0;
+	state->primed = 0;
+	memset(spectral_features_mags(state_bytes, 0), 0, (size_t)2 * count * bins * sizeof(float));
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "spectral_features_finish_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "spectral_features_state"
+
+// Descriptors of one magnitude spectrum. prev is the spectrum before it (the previous one in
+// the batch, or the last one of the previous call), or NULL when there is none and the flux
+// is 0. The magnitudes were just written by the caller, so both passes run from cache.
+// Computing bandwidth as E[(k - c)^2] instead of E[k^2] - c^2 avoids cancellation in float.
+static inline void spectral_features_finish_f32(const float* restrict mag, const float* restrict prev, int bins,
+	float bin_hz, float roll_percent, float* restrict out)
+{
+	float sum_m = 0.0f, sum_km = 0.0f, sum_p = 0.0f, sum_logp = 0.0f, flux = 0.0f;
+	for (int k = 0; k < bins; k++) {
+		const float m = mag[k];
+		sum_m += m;
+		sum_km += (float)k * m;
+
+		float p = m * m;
+		if (p < SPECTRAL_AMIN)
+			p = SPECTRAL_AMIN;
+		sum_p += p;
+		sum_logp += logf(p);
+	}
+	if (prev) {
+		for (int k = 0; k < bins; k++) {
+			const float d = mag[k] - prev[k];
+			flux += d * d;
+		}
+	}
+
+	out[SPECTRAL_FLATNESS] = expf(sum_logp / bins) / (sum_p / bins);
+	out[SPECTRAL_FLUX] = sqrtf(flux);
+
+	if (sum_m <= 0.0f) {
+		out[SPECTRAL_CENTROID] = 0.0f;
+		out[SPECTRAL_BANDWIDTH] = 0.0f;
+		out[SPECTRAL_ROLLOFF] = 0.0f;
+		return;
+	}
+
+	const float centroid = sum_km / sum_m;
+	const float threshold = roll_percent * sum_m;
+	float cum = 0.0f;
+	float var = 0.0f;
+	int rolloff = -1;
+	for (int k = 0; k < bins; k++) {
+		const float m = mag[k];
+		const float d = (float)k - centroid;
+		var += m * d * d;
+		cum += m;
+		if (rolloff < 0 && cum >= threshold)
+			rolloff = k;
+	}
+	if (rolloff < 0)
+		rolloff = bins - 1;
+
+	out[SPECTRAL_CENTROID] = centroid * bin_hz;
+	out[SPECTRAL_BANDWIDTH] = sqrtf(var / sum_m) * bin_hz;
+	out[SPECTRAL_ROLLOFF] = rolloff * bin_hz;
+}
+
+// Spectrum preceding spectrum c of the current call, NULL for the very first one.
+static inline const float* spectral_features_prev(void* state_ptr, const float* cur, int c)
+{
+	spectral_features_state* state = (spectral_features_state*)state_ptr;
+	if (c > 0)
+		return cur - state->bins;
+	if (!state->primed)
+		return NULL;
+	return spectral_features_mags(state_ptr, state->current ^ 1) + (size_t)(state->count - 1) * state->bins;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "spectral_features_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "spectral_features_finish_f32"
+
+// input  [count, bins, 2] RealFft output ([real, imaginary] pairs)
+// output [count, 5] centroid (Hz), bandwidth (Hz), rolloff (Hz), flatness, flux
+// bin_hz = sample_rate / (2 * (bins - 1))
+// Each spectrum is read once, into the magnitudes kept in the handle for the flux of the next
+// spectrum; every descriptor is then computed from those magnitudes.
+static inline void spectral_features_f32(const float* restrict input, int8_t* restrict state_bytes,
+	float* restrict output, float bin_hz, float roll_percent)
+{
+	spectral_features_state* state = (spectral_features_state*)state_bytes;
+	const int bins = state->bins;
+	const int count = state->count;
+	float* cur = spectral_features_mags(state_bytes, state->current);
+
+	for (int c = 0; c < count; c++) {
+		const float* x = input + c * bins * 2;
+		for (int k = 0; k < bins; k++) {
+			const float re = x[2 * k];
+			const float im = x[2 * k + 1];
+			cur[k] = sqrtf(re * re + im * im);
+		}
+
+		spectral_features_finish_f32(cur, spectral_features_prev(state_bytes, cur, c), bins, bin_hz, roll_percent,
+			output + c * SPECTRAL_FEATURES);
+		cur += bins;
+	}
+
+	state->current ^= 1;
+	state->primed = 1;
+}
+
+#pragma IMAGINET_FRAGMENT_END
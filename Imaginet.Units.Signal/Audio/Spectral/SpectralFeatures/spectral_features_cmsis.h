@@ -0,0 +1,42 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <math.h>
+#include "arm_math.h"
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_CODEPACKAGE_DEPENDENCY "cmsis-dsp"
+
+#pragma IMAGINET_FRAGMENT_BEGIN "spectral_features_cmsis_q15"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "spectral_features.h:spectral_features_finish_f32"
+
+// input  [count, bins, 2] q15 RealFft output
+// output [count, 5] float32 centroid (Hz), bandwidth (Hz), rolloff (Hz), flatness, flux
+// scale  = real value of one LSB of the 2.14 magnitudes from arm_cmplx_mag_q15
+// CMSIS computes the fixed-point magnitudes into the staging area of the handle. They are
+// converted to real magnitudes in the float buffers, and the descriptors are computed by the
+// same code as for float32 input.
+static inline void spectral_features_cmsis_q15(const q15_t* restrict input, int8_t* restrict state_bytes,
+	float* restrict output, float bin_hz, float roll_percent, float scale)
+{
+	spectral_features_state* state = (spectral_features_state*)state_bytes;
+	const int bins = state->bins;
+	const int count = state->count;
+	float* cur = spectral_features_mags(state_bytes, state->current);
+	q15_t* staging = (q15_t*)spectral_features_staging(state_bytes);
+
+	for (int c = 0; c < count; c++) {
+		arm_cmplx_mag_q15(input + c * bins * 2, staging, bins);
+		for (int k = 0; k < bins; k++) {
+			cur[k] = (float)staging[k] * scale;
+		}
+
+		spectral_features_finish_f32(cur, spectral_features_prev(state_bytes, cur, c), bins, bin_hz, roll_percent,
+			output + c * SPECTRAL_FEATURES);
+		cur += bins;
+	}
+
+	state->current ^= 1;
+	state->primed = 1;
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,142 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "oscillator_bank_init_f32"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Handle layout (size = count * 8 bytes):
+//   double phase[count]    phase of every oscillator at the start of the next call, in [0, 2π)
+static inline int oscillator_bank_init_f32(int8_t* restrict state_bytes, int count, float initial_phase)
+{
+	double* phase = (double*)state_bytes;
+	double phi = fmod((double)initial_phase, 2.0 * M_PI);
+	if (phi < 0.0) {
+		phi += 2.0 * M_PI;
+	}
+
+	for (int k = 0; k < count; k++) {
+		phase[k] = phi;
+	}
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "oscillator_bank_run_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "oscillator_bank_init_f32"
+
+// Number of samples between renormalizations of the phasors, and the number of oscillators
+// whose rotation steps are kept on the stack.
+#define OSCILLATOR_BANK_RENORM 64
+#define OSCILLATOR_BANK_TILE 64
+
+// Every oscillator is a unit phasor re + i*im that is rotated by exp(i*2*pi*f/fs) per sample;
+// the output is amplitude * im, i.e. amplitude * sin(phase). Rounding slowly changes the
+// phasor magnitude, so every OSCILLATOR_BANK_RENORM samples it is pulled back to 1 with one
+// Newton step of 1/sqrt (exact to first order, no sqrt or division).
+// The phase itself is tracked in double in the handle and the phasor is rebuilt from it at the
+// start of every call, so float rounding never accumulates beyond one buffer. The waveform is
+// continuous across calls, and a change of frequency between calls continues from the current phase.
+// Oscillators are processed in tiles and the inner loops run over contiguous oscillators so
+// the compiler can vectorize them. Output is [length][count], or [length] when mix is set.
+static inline void oscillator_bank_run_f32(int8_t* restrict state_bytes, const float* restrict frequencies,
+	const float* restrict amplitudes, int amplitude_step, float* restrict output,
+	int length, int count, float sample_rate, int mix)
+{
+	double* phase = (double*)state_bytes;
+	float rc[OSCILLATOR_BANK_TILE], rs[OSCILLATOR_BANK_TILE], amp[OSCILLATOR_BANK_TILE];
+	float re[OSCILLATOR_BANK_TILE], im[OSCILLATOR_BANK_TILE];
+
+	if (mix) {
+		for (int t = 0; t < length; t++) {
+			output[t] = 0.0f;
+		}
+	}
+
+	for (int k0 = 0; k0 < count; k0 += OSCILLATOR_BANK_TILE) {
+		int n = count - k0 < OSCILLATOR_BANK_TILE ? count - k0 : OSCILLATOR_BANK_TILE;
+
+		for (int k = 0; k < n; k++) {
+			double w = 2.0 * M_PI * frequencies[k0 + k] / sample_rate;
+			double phi = phase[k0 + k];
+			rc[k] = (float)cos(w);
+			rs[k] = (float)sin(w);
+			amp[k] = amplitudes[(k0 + k) * amplitude_step];
+			re[k] = (float)cos(phi);
+			im[k] = (float)sin(phi);
+
+			phi = fmod(phi + w * length, 2.0 * M_PI);
+			if (phi < 0.0) {
+				phi += 2.0 * M_PI;
+			}
+			phase[k0 + k] = phi;
+		}
+
+		for (int t0 = 0; t0 < length; t0 += OSCILLATOR_BANK_RENORM) {
+			int t1 = length - t0 < OSCILLATOR_BANK_RENORM ? length : t0 + OSCILLATOR_BANK_RENORM;
+
+			for (int t = t0; t < t1; t++) {
+				if (mix) {
+					float sum = 0.0f;
+					for (int k = 0; k < n; k++) {
+						sum += amp[k] * im[k];
+					}
+					output[t] += sum;
+				}
+				else {
+					float* out = output + t * count + k0;
+					for (int k = 0; k < n; k++) {
+						out[k] = amp[k] * im[k];
+					}
+				}
+
+				for (int k = 0; k < n; k++) {
+					float r = re[k] * rc[k] - im[k] * rs[k];
+					float i = re[k] * rs[k] + im[k] * rc[k];
+					re[k] = r;
+					im[k] = i;
+				}
+			}
+
+			for (int k = 0; k < n; k++) {
+				float g = 1.5f - 0.5f * (re[k] * re[k] + im[k] * im[k]);
+				re[k] *= g;
+				im[k] *= g;
+			}
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "oscillator_bank_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "oscillator_bank_run_f32"
+
+// All oscillators share one amplitude.
+static inline void oscillator_bank_f32(int8_t* restrict state_bytes, const float* restrict frequencies,
+	float* restrict output, int length, int count, float sample_rate, float amplitude, int mix)
+{
+	oscillator_bank_run_f32(state_bytes, frequencies, &amplitude, 0, output, length, count, sample_rate, mix);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "oscillator_bank_amplitudes_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "oscillator_bank_run_f32"
+
+// One amplitude per oscillator.
+static inline void oscillator_bank_amplitudes_f32(int8_t* restrict state_bytes, const float* restrict frequencies,
+	const float* restrict amplitudes, float* restrict output, int length, int count, float sample_rate, int mix)
+{
+	oscillator_bank_run_f32(state_bytes, frequencies, amplitudes, 1, output, length, count, sample_rate, mix);
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,32 @@
+/*
+* Imagimob AB CONFIDENTIAL
+* Unpublished Copyright (c) 2019- [Imagimob AB], All Rights Reserved.
+* NOTICE: All information contained herein is, and remains the property of Imagimob AB.
+*/
+
+using System;
+
+namespace Imaginet.Units.Signal.Blackman;
+
+public static class Blackman
+{
+    /// <summary>
+    /// Classic Blackman window: 0.42 - 0.5 cos(2πx) + 0.08 cos(4πx).
+    /// </summary>
+    /// <param name="size"></param>
+    /// <param name="sym"> When True, generates a symmetric window, for use in filter design. 
+    /// When False, generates a periodic window, for use in spectral analysis.</param>
+    /// <returns></returns>
+    public static float[] BlackmanTableF32(int size, bool sym)
+    {
+        var data = new float[size];
+
+        for (int i = 0; i < data.Length; i++)
+        {
+            var frac = sym ? i / (data.Length - 1.0) : (double)i / data.Length;
+            data[i] = (float)(0.42 - 0.5 * Math.Cos(2.0 * Math.PI * frac) + 0.08 * Math.Cos(4.0 * Math.PI * frac));
+        }
+
+        return data;
+    }
+}
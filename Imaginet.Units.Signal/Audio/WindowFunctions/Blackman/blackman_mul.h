@@ -0,0 +1,7 @@
+#pragma IMAGINET_FRAGMENT_BEGIN "blackmanmul_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../window_mul.h:windowmul_f32"
+static inline void blackmanmul_f32(const float* restrict input, const float* restrict w, int d0, int d1, int d2, float* restrict output)
+{
+	windowmul_f32(input, w, d0, d1, d2, output);
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,37 @@
+/*
+* Imagimob AB CONFIDENTIAL
+* Unpublished Copyright (c) 2019- [Imagimob AB], All Rights Reserved.
+* NOTICE: All information contained herein is, and remains the property of Imagimob AB.
+*/
+
+using System;
+
+namespace Imaginet.Units.Signal.BlackmanHarris;
+
+public static class BlackmanHarris
+{
+    /// <summary>
+    /// Minimum 4-term Blackman-Harris window (-92 dB side lobes).
+    /// </summary>
+    /// <param name="size"></param>
+    /// <param name="sym"> When True, generates a symmetric window, for use in filter design. 
+    /// When False, generates a periodic window, for use in spectral analysis.</param>
+    /// <returns></returns>
+    public static float[] BlackmanHarrisTableF32(int size, bool sym)
+    {
+        var data = new float[size];
+        var a0 = 0.35875;
+        var a1 = 0.48829;
+        var a2 = 0.14128;
+        var a3 = 0.01168;
+
+        for (int i = 0; i < data.Length; i++)
+        {
+            var frac = sym ? i / (data.Length - 1.0) : (double)i / data.Length;
+            var x = 2.0 * Math.PI * frac;
+            data[i] = (float)(a0 - a1 * Math.Cos(x) + a2 * Math.Cos(2.0 * x) - a3 * Math.Cos(3.0 * x));
+        }
+
+        return data;
+    }
+}
@@ -0,0 +1,12 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+import numpy as np
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "blackmanharris_mul"
+
+def blackmanharris_mul(a, b, output, axis):
+    shape = [1] * a.ndim
+    shape[a.ndim - 1 - axis] = len(b)
+    np.multiply(a, np.reshape(b, shape), out=output)
+
+#pragma IMAGINET_FRAGMENT_END
@@ -1,26 +1,7 @@
 ﻿#pragma IMAGINET_FRAGMENT_BEGIN "hammingmul_f32"
-// input array (any shape >= 1D)
-// output array (same shape as input array)
-// d0 = input.shape.step(axis)
-// d1 = input.shape.size(axis)
-// d2 = input.shape.slot(axis)
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../window_mul.h:windowmul_f32"
 static inline void hammingmul_f32(const float* restrict input, const float* restrict w, int d0, int d1, int d2, float* restrict output)
 {
-	const int d3 = d0 * d1;
-
-	const float* ip = input;
-	float* op = output;
- 
-	for (int j = 0; j < d2; j++) {
-		for (int i = 0; i < d0; i++) {
-			for (int k = 0; k < d1; k++) {
-				op[k * d0 + i] = ip[k * d0 + i] * w[k];
-			}
-		}
-
-		ip += d3;
-		op += d3;
-	}
+	windowmul_f32(input, w, d0, d1, d2, output);
 }
-
 #pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
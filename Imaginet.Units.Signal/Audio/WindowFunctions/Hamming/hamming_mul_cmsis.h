@@ -36,8 +36,8 @@ static inline void hammingmul_cmsis_sparse_q31(const q31_t* restrict input, cons
 	q31_t* op = output;
 
 	for (int j = 0; j < d2; j++) {
-		for (int i = 0; i < d0; i++) {
-			for (int k = 0; k < d1; k++) {
+		for (int k = 0; k < d1; k++) {
+			for (int i = 0; i < d0; i++) {
 				op[k * d0 + i] = ARM_MULT_Q31_SAT(ip[k * d0 + i], w[k]);
 			}
 		}
@@ -69,8 +69,8 @@ static inline void hammingmul_cmsis_sparse_q15(const q15_t* restrict input, cons
 	q15_t* op = output;
 
 	for (int j = 0; j < d2; j++) {
-		for (int i = 0; i < d0; i++) {
-			for (int k = 0; k < d1; k++) {
+		for (int k = 0; k < d1; k++) {
+			for (int i = 0; i < d0; i++) {
 				op[k * d0 + i] = ARM_MULT_Q15_SAT(ip[k * d0 + i], w[k]);
 			}
 		}
@@ -103,8 +103,8 @@ static inline void hammingmul_cmsis_sparse_q7(const q7_t* restrict input, const
 	q7_t* op = output;
 
 	for (int j = 0; j < d2; j++) {
-		for (int i = 0; i < d0; i++) {
-			for (int k = 0; k < d1; k++) {
+		for (int k = 0; k < d1; k++) {
+			for (int i = 0; i < d0; i++) {
 				op[k * d0 + i] = ARM_MULT_Q7_SAT(ip[k * d0 + i], w[k]);
 			}
 		}
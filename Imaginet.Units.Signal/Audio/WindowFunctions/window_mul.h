@@ -0,0 +1,28 @@
+#pragma IMAGINET_FRAGMENT_BEGIN "windowmul_f32"
+// Multiplies every slice along an axis by a window, shared by the window function units.
+// input array (any shape >= 1D)
+// output array (same shape as input array)
+// d0 = input.shape.step(axis)
+// d1 = input.shape.size(axis)
+// d2 = input.shape.slot(axis)
+// Iterates in memory order: each of the d1 rows of d0 contiguous elements is scaled by w[k].
+static inline void windowmul_f32(const float* restrict input, const float* restrict w, int d0, int d1, int d2, float* restrict output)
+{
+	const int d3 = d0 * d1;
+
+	const float* ip = input;
+	float* op = output;
+
+	for (int j = 0; j < d2; j++) {
+		for (int k = 0; k < d1; k++) {
+			const float wk = w[k];
+			for (int i = 0; i < d0; i++) {
+				op[k * d0 + i] = ip[k * d0 + i] * wk;
+			}
+		}
+
+		ip += d3;
+		op += d3;
+	}
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,233 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "biquad_state_f32"
+
+// Number of channels processed together by the cascade kernel. The tile is kept
+// on the stack so all sections run on it before it is written back to memory.
+#define BIQUAD_TILE 64
+
+// Coefficients per section: b0, b1, b2, a1, a2 (normalised so that a0 == 1).
+#define BIQUAD_COEFFS 5
+
+// Handle layout (size = 8 + sections * 20 + sections * count * 8 bytes):
+//   biquad_state_f32 header
+//   float coeffs[sections][BIQUAD_COEFFS]
+//   float z[sections][2][count]      transposed direct form II delay lines,
+//                                    channel-contiguous so the kernel vectorizes over channels
+typedef struct {
+	int32_t sections;
+	int32_t count;
+} biquad_state_f32;
+
+static inline float* biquad_coeffs_f32(void* state_ptr)
+{
+	return (float*)((char*)state_ptr + sizeof(biquad_state_f32));
+}
+
+static inline float* biquad_delay_f32(void* state_ptr)
+{
+	biquad_state_f32* state = (biquad_state_f32*)state_ptr;
+	return biquad_coeffs_f32(state_ptr) + state->sections * BIQUAD_COEFFS;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "biquad_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "biquad_state_f32"
+
+// Reset the handle to a cascade of 'sections' pass-through sections with cleared delay lines.
+// The caller designs the coefficients afterwards with the biquad_design_* functions.
+static inline void biquad_init_f32(void* state_ptr, int count, int sections)
+{
+	biquad_state_f32* state = (biquad_state_f32*)state_ptr;
+	state->sections = sections;
+	state->count = count;
+
+	float* coeffs = biquad_coeffs_f32(state_ptr);
+	for (int s = 0; s < sections; s++) {
+		float* c = coeffs + s * BIQUAD_COEFFS;
+		c[0] = 1.0f;
+		c[1] = 0.0f;
+		c[2] = 0.0f;
+		c[3] = 0.0f;
+		c[4] = 0.0f;
+	}
+
+	memset(biquad_delay_f32(state_ptr), 0, (size_t)sections * 2 * count * sizeof(float));
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "biquad_design_f32"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Audio EQ Cookbook (R. Bristow-Johnson) designs. Each writes b0, b1, b2, a1, a2 divided by a0.
+// Computed in double so that narrow, low-frequency sections keep their accuracy.
+
+static inline void biquad_normalize_f32(float* restrict c, double b0, double b1, double b2, double a0, double a1, double a2)
+{
+	c[0] = (float)(b0 / a0);
+	c[1] = (float)(b1 / a0);
+	c[2] = (float)(b2 / a0);
+	c[3] = (float)(a1 / a0);
+	c[4] = (float)(a2 / a0);
+}
+
+static inline void biquad_design_notch_f32(float* restrict c, float sample_rate, float frequency, float Q)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	biquad_normalize_f32(c, 1.0, -2.0 * cos_w0, 1.0, 1.0 + alpha, -2.0 * cos_w0, 1.0 - alpha);
+}
+
+static inline void biquad_design_peaking_f32(float* restrict c, float sample_rate, float frequency, float Q, float gain_db)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	double A = pow(10.0, gain_db / 40.0);
+	biquad_normalize_f32(c,
+		1.0 + alpha * A, -2.0 * cos_w0, 1.0 - alpha * A,
+		1.0 + alpha / A, -2.0 * cos_w0, 1.0 - alpha / A);
+}
+
+static inline void biquad_design_low_shelf_f32(float* restrict c, float sample_rate, float frequency, float Q, float gain_db)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	double A = pow(10.0, gain_db / 40.0);
+	double tsa = 2.0 * sqrt(A) * alpha;
+	biquad_normalize_f32(c,
+		A * ((A + 1.0) - (A - 1.0) * cos_w0 + tsa),
+		2.0 * A * ((A - 1.0) - (A + 1.0) * cos_w0),
+		A * ((A + 1.0) - (A - 1.0) * cos_w0 - tsa),
+		(A + 1.0) + (A - 1.0) * cos_w0 + tsa,
+		-2.0 * ((A - 1.0) + (A + 1.0) * cos_w0),
+		(A + 1.0) + (A - 1.0) * cos_w0 - tsa);
+}
+
+static inline void biquad_design_high_shelf_f32(float* restrict c, float sample_rate, float frequency, float Q, float gain_db)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	double A = pow(10.0, gain_db / 40.0);
+	double tsa = 2.0 * sqrt(A) * alpha;
+	biquad_normalize_f32(c,
+		A * ((A + 1.0) + (A - 1.0) * cos_w0 + tsa),
+		-2.0 * A * ((A - 1.0) + (A + 1.0) * cos_w0),
+		A * ((A + 1.0) + (A - 1.0) * cos_w0 - tsa),
+		(A + 1.0) - (A - 1.0) * cos_w0 + tsa,
+		2.0 * ((A - 1.0) - (A + 1.0) * cos_w0),
+		(A + 1.0) - (A - 1.0) * cos_w0 - tsa);
+}
+
+static inline void biquad_design_lowpass_f32(float* restrict c, float sample_rate, float frequency, float Q)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	biquad_normalize_f32(c,
+		(1.0 - cos_w0) * 0.5, 1.0 - cos_w0, (1.0 - cos_w0) * 0.5,
+		1.0 + alpha, -2.0 * cos_w0, 1.0 - alpha);
+}
+
+static inline void biquad_design_highpass_f32(float* restrict c, float sample_rate, float frequency, float Q)
+{
+	double w0 = 2.0 * M_PI * frequency / sample_rate;
+	double cos_w0 = cos(w0);
+	double alpha = sin(w0) / (2.0 * Q);
+	biquad_normalize_f32(c,
+		(1.0 + cos_w0) * 0.5, -(1.0 + cos_w0), (1.0 + cos_w0) * 0.5,
+		1.0 + alpha, -2.0 * cos_w0, 1.0 - alpha);
+}
+
+// First-order sections (bilinear transform with prewarping), stored as biquads with b2 = a2 = 0.
+static inline void biquad_design_lowpass1_f32(float* restrict c, float sample_rate, float frequency)
+{
+	double K = tan(M_PI * frequency / sample_rate);
+	biquad_normalize_f32(c, K, K, 0.0, K + 1.0, K - 1.0, 0.0);
+}
+
+static inline void biquad_design_highpass1_f32(float* restrict c, float sample_rate, float frequency)
+{
+	double K = tan(M_PI * frequency / sample_rate);
+	biquad_normalize_f32(c, 1.0, -1.0, 0.0, K + 1.0, K - 1.0, 0.0);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "biquad_cascade_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "biquad_state_f32"
+
+// Run one input frame of 'count' independent channels through every section of the cascade
+// (transposed direct form II). Channels are processed in tiles of BIQUAD_TILE: each tile is
+// loaded once, filtered by all sections while it stays in registers/L1, then stored once.
+// The inner loops run over contiguous channels and are written for the compiler to vectorize.
+static inline void biquad_cascade_f32(const float* restrict input, void* restrict state_ptr, float* restrict output)
+{
+	biquad_state_f32* state = (biquad_state_f32*)state_ptr;
+	const int sections = state->sections;
+	const int count = state->count;
+	const float* coeffs = biquad_coeffs_f32(state_ptr);
+	float* delay = biquad_delay_f32(state_ptr);
+
+	float x[BIQUAD_TILE];
+
+	for (int i0 = 0; i0 < count; i0 += BIQUAD_TILE) {
+		int n = count - i0 < BIQUAD_TILE ? count - i0 : BIQUAD_TILE;
+
+		for (int k = 0; k < n; k++) {
+			x[k] = input[i0 + k];
+		}
+
+		for (int s = 0; s < sections; s++) {
+			const float* c = coeffs + s * BIQUAD_COEFFS;
+			const float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+			float* restrict z1 = delay + (s * 2) * count + i0;
+			float* restrict z2 = delay + (s * 2 + 1) * count + i0;
+
+			for (int k = 0; k < n; k++) {
+				float xk = x[k];
+				float y = b0 * xk + z1[k];
+				z1[k] = b1 * xk - a1 * y + z2[k];
+				z2[k] = b2 * xk - a2 * y;
+				x[k] = y;
+			}
+		}
+
+		for (int k = 0; k < n; k++) {
+			output[i0 + k] = x[k];
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "biquad_cascade_block_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "biquad_cascade_f32"
+
+// Filter a block of 'frames' consecutive frames of 'count' channels each, with time as the
+// outermost axis. The delay lines carry over between frames and between calls.
+static inline void biquad_cascade_block_f32(const float* restrict input, void* restrict state_ptr, float* restrict output, int frames)
+{
+	const int count = ((biquad_state_f32*)state_ptr)->count;
+	for (int f = 0; f < frames; f++) {
+		biquad_cascade_f32(input + f * count, state_ptr, output + f * count);
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,278 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_state_f32"
+
+// Handle layout (size = 16 + num_taps * 4 + 2 * num_taps * count * 4 bytes):
+//   fir_state_f32 header
+//   float taps[num_taps]                 stored time-reversed (oldest frame first)
+//   float delay[2 * num_taps][count]     mirrored delay line: every frame is written twice,
+//                                        num_taps frames apart, so the latest num_taps frames
+//                                        are always contiguous in memory (no wrap in the MAC)
+typedef struct {
+	int32_t num_taps;
+	int32_t count;
+	int32_t pos;		// Delay line slot of the next frame, in [0, num_taps)
+	int32_t phase;		// Frames since the last kept output, in [0, decimation)
+} fir_state_f32;
+
+static inline float* fir_taps_f32(void* state_ptr)
+{
+	return (float*)((char*)state_ptr + sizeof(fir_state_f32));
+}
+
+static inline float* fir_delay_f32(void* state_ptr)
+{
+	fir_state_f32* state = (fir_state_f32*)state_ptr;
+	return fir_taps_f32(state_ptr) + state->num_taps;
+}
+
+static inline void fir_reset_f32(void* state_ptr, int num_taps, int count)
+{
+	fir_state_f32* state = (fir_state_f32*)state_ptr;
+	state->num_taps = num_taps;
+	state->count = count;
+	state->pos = 0;
+	state->phase = 0;
+	memset(fir_delay_f32(state_ptr), 0, (size_t)2 * num_taps * count * sizeof(float));
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_mac_f32"
+
+// Number of channel accumulators kept on the stack by the multi-channel MAC kernel.
+#define FIR_TILE 64
+
+// Multi-channel generalization of dot_mac_f32:
+//   out[c] = sum_j taps[j] * window[j * count + c]   for c in [0, count)
+// The window holds num_taps frames of 'count' channels, oldest first.
+// With several channels the inner loop runs over contiguous channels (one broadcast tap per
+// frame) and vectorizes; a single channel falls back to a dot product with 4 independent
+// accumulators to break the serial add dependency.
+static inline void fir_mac_f32(const float* restrict window, const float* restrict taps,
+	float* restrict out, int num_taps, int count)
+{
+	if (count == 1) {
+		float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		int j = 0;
+		for (; j + 4 <= num_taps; j += 4) {
+			s0 += taps[j] * window[j];
+			s1 += taps[j + 1] * window[j + 1];
+			s2 += taps[j + 2] * window[j + 2];
+			s3 += taps[j + 3] * window[j + 3];
+		}
+		for (; j < num_taps; j++) {
+			s0 += taps[j] * window[j];
+		}
+		out[0] = (s0 + s1) + (s2 + s3);
+		return;
+	}
+
+	float acc[FIR_TILE];
+	for (int c0 = 0; c0 < count; c0 += FIR_TILE) {
+		int n = count - c0 < FIR_TILE ? count - c0 : FIR_TILE;
+		for (int k = 0; k < n; k++) {
+			acc[k] = 0.0f;
+		}
+		const float* w = window + c0;
+		for (int j = 0; j < num_taps; j++) {
+			const float t = taps[j];
+			for (int k = 0; k < n; k++) {
+				acc[k] += t * w[k];
+			}
+			w += count;
+		}
+		for (int k = 0; k < n; k++) {
+			out[c0 + k] = acc[k];
+		}
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_design_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_state_f32"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Response and window types, matching the OneOf items of FIRFilter.imunit.
+#define FIR_FILTER_LOWPASS 0
+#define FIR_FILTER_HIGHPASS 1
+#define FIR_FILTER_BANDPASS 2
+
+#define FIR_WINDOW_RECTANGULAR 0
+#define FIR_WINDOW_HANN 1
+#define FIR_WINDOW_HAMMING 2
+#define FIR_WINDOW_BLACKMAN 3
+
+static inline double fir_window_f32(int window, int n, int num_taps)
+{
+	if (num_taps == 1)
+		return 1.0;
+	double x = 2.0 * M_PI * n / (num_taps - 1);
+	switch (window) {
+	case FIR_WINDOW_HANN:
+		return 0.5 - 0.5 * cos(x);
+	case FIR_WINDOW_HAMMING:
+		return 0.54 - 0.46 * cos(x);
+	case FIR_WINDOW_BLACKMAN:
+		return 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+	default:
+		return 1.0;
+	}
+}
+
+// Windowed-sinc low-pass tap n with normalized cutoff fc (cycles/sample), before windowing.
+static inline double fir_sinc_f32(int n, int num_taps, double fc)
+{
+	double m = n - 0.5 * (num_taps - 1);
+	if (m == 0.0)
+		return 2.0 * fc;
+	return sin(2.0 * M_PI * fc * m) / (M_PI * m);
+}
+
+// Design linear-phase taps by the window method and store them time-reversed in the handle.
+// High-pass is built by spectral inversion and band-pass as the difference of two low-pass
+// prototypes, so both need an odd number of taps. The taps are scaled to unit gain at the
+// center of the pass band (DC, Nyquist or the band center).
+static inline void fir_design_f32(void* state_ptr, int response, int window,
+	float sample_rate, float cutoff_freq, float low_cutoff_freq, float high_cutoff_freq)
+{
+	fir_state_f32* state = (fir_state_f32*)state_ptr;
+	const int num_taps = state->num_taps;
+	float* taps = fir_taps_f32(state_ptr);
+
+	double f_lp = (response == FIR_FILTER_BANDPASS ? high_cutoff_freq : cutoff_freq) / sample_rate;
+	double f_hp = (response == FIR_FILTER_BANDPASS ? low_cutoff_freq : cutoff_freq) / sample_rate;
+	double f_ref = response == FIR_FILTER_HIGHPASS ? 0.5 : response == FIR_FILTER_BANDPASS ? 0.5 * (f_lp + f_hp) : 0.0;
+
+	double gain = 0.0;
+	for (int n = 0; n < num_taps; n++) {
+		double h;
+		if (response == FIR_FILTER_HIGHPASS)
+			h = fir_sinc_f32(n, num_taps, 0.5) - fir_sinc_f32(n, num_taps, f_hp);
+		else if (response == FIR_FILTER_BANDPASS)
+			h = fir_sinc_f32(n, num_taps, f_lp) - fir_sinc_f32(n, num_taps, f_hp);
+		else
+			h = fir_sinc_f32(n, num_taps, f_lp);
+		h *= fir_window_f32(window, n, num_taps);
+
+		gain += h * cos(2.0 * M_PI * f_ref * (n - 0.5 * (num_taps - 1)));
+		taps[num_taps - 1 - n] = (float)h;
+	}
+
+	for (int n = 0; n < num_taps; n++) {
+		taps[n] = (float)(taps[n] / gain);
+	}
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_design_f32"
+
+static inline int fir_filter_init_f32(int8_t* restrict state_bytes, int count, int sample_rate, int num_taps,
+	int response, int window, float cutoff_freq, float low_cutoff_freq, float high_cutoff_freq)
+{
+	fir_reset_f32(state_bytes, num_taps, count);
+	fir_design_f32(state_bytes, response, window, (float)sample_rate, cutoff_freq, low_cutoff_freq, high_cutoff_freq);
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter_taps_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_state_f32"
+
+static inline int fir_filter_taps_init_f32(int8_t* restrict state_bytes, int count, int num_taps)
+{
+	fir_reset_f32(state_bytes, num_taps, count);
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter_run_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_state_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_mac_f32"
+
+// Push 'frames' input frames through the delay line and emit one output frame for every
+// 'decimation' input frames. Outputs that decimation would discard are never computed.
+// 'reversed_taps' must hold num_taps coefficients, oldest frame first.
+static inline void fir_filter_run_f32(const float* restrict input, const float* restrict reversed_taps,
+	void* restrict state_ptr, float* restrict output, int frames, int decimation)
+{
+	fir_state_f32* state = (fir_state_f32*)state_ptr;
+	const int num_taps = state->num_taps;
+	const int count = state->count;
+	float* delay = fir_delay_f32(state_ptr);
+	int pos = state->pos;
+	int phase = state->phase;
+
+	for (int f = 0; f < frames; f++) {
+		const float* x = input + f * count;
+		memcpy(delay + pos * count, x, count * sizeof(float));
+		memcpy(delay + (pos + num_taps) * count, x, count * sizeof(float));
+
+		pos++;
+		if (pos == num_taps)
+			pos = 0;
+
+		if (phase == 0) {
+			// Frames pos .. pos + num_taps - 1 are the latest num_taps frames, oldest first.
+			fir_mac_f32(delay + pos * count, reversed_taps, output, num_taps, count);
+			output += count;
+		}
+
+		phase++;
+		if (phase == decimation)
+			phase = 0;
+	}
+
+	state->pos = pos;
+	state->phase = phase;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_filter_run_f32"
+
+static inline void fir_filter_f32(const float* restrict input, int8_t* restrict state_bytes,
+	float* restrict output, int frames, int decimation)
+{
+	fir_filter_run_f32(input, fir_taps_f32(state_bytes), state_bytes, output, frames, decimation);
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter_taps_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "fir_filter_run_f32"
+
+// Taps supplied as a tensor in natural order (taps[0] applies to the newest frame).
+// They are copied reversed into the handle so that the MAC walks both arrays forward.
+static inline void fir_filter_taps_f32(const float* restrict input, const float* restrict taps,
+	int8_t* restrict state_bytes, float* restrict output, int frames, int decimation)
+{
+	fir_state_f32* state = (fir_state_f32*)state_bytes;
+	float* reversed = fir_taps_f32(state_bytes);
+	for (int n = 0; n < state->num_taps; n++) {
+		reversed[state->num_taps - 1 - n] = taps[n];
+	}
+	fir_filter_run_f32(input, reversed, state_bytes, output, frames, decimation);
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,21 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+import numpy as np
+from scipy import signal
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "fir_filter"
+
+
+def fir_filter(input, taps, output, num_taps, response, window, cutoff_freq, low_cutoff_freq, high_cutoff_freq, decimation, freq):
+    if taps is None:
+        windows = ["boxcar", "hann", "hamming", "blackman"]
+        if response == 2:
+            taps = signal.firwin(num_taps, [low_cutoff_freq, high_cutoff_freq], window=windows[window], pass_zero=False, fs=freq)
+        else:
+            taps = signal.firwin(num_taps, cutoff_freq, window=windows[window], pass_zero=(response == 0), fs=freq)
+
+    result = signal.lfilter(np.ravel(taps), [1.0], input, axis=0)
+    np.copyto(output, result[::decimation])
+
+
+#pragma IMAGINET_FRAGMENT_END
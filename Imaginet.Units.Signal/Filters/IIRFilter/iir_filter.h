@@ -0,0 +1,108 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "iir_filter_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_design_f32"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Response and design types, matching the OneOf items of IIRFilter.imunit.
+#define IIR_FILTER_LOWPASS 0
+#define IIR_FILTER_HIGHPASS 1
+#define IIR_FILTER_BANDPASS 2
+
+#define IIR_FILTER_BUTTERWORTH 0
+#define IIR_FILTER_CHEBYSHEV1 1
+
+// Design a low-pass or high-pass filter of the given order as ceil(order / 2) sections.
+// Each analog prototype pole pair (cutoff 1 rad/s) has natural frequency omega and quality Q;
+// the pair maps to one cookbook section whose corner is placed so that the bilinear transform
+// lands the prototype cutoff exactly on 'cutoff_freq'. Odd orders add one first-order section.
+static inline float* iir_filter_design_f32(float* restrict c, int highpass, int design, int order,
+	float sample_rate, float cutoff_freq, float ripple_db)
+{
+	double sr = 1.0, ci = 1.0;
+	if (design == IIR_FILTER_CHEBYSHEV1) {
+		double eps = sqrt(pow(10.0, ripple_db / 10.0) - 1.0);
+		double mu = asinh(1.0 / eps) / order;
+		sr = sinh(mu);
+		ci = cosh(mu);
+	}
+
+	double t = tan(M_PI * cutoff_freq / sample_rate);
+	float* first = c;
+
+	for (int k = 0; k < order / 2; k++) {
+		double theta = M_PI * (2 * k + 1) / (2.0 * order);
+		double re = sr * sin(theta);
+		double im = ci * cos(theta);
+		double omega = sqrt(re * re + im * im);
+		float Q = (float)(omega / (2.0 * re));
+
+		if (highpass) {
+			biquad_design_highpass_f32(c, sample_rate, (float)(sample_rate / M_PI * atan(t / omega)), Q);
+		}
+		else {
+			biquad_design_lowpass_f32(c, sample_rate, (float)(sample_rate / M_PI * atan(t * omega)), Q);
+		}
+		c += BIQUAD_COEFFS;
+	}
+
+	if (order & 1) {
+		// Real pole at theta = pi / 2
+		if (highpass) {
+			biquad_design_highpass1_f32(c, sample_rate, (float)(sample_rate / M_PI * atan(t / sr)));
+		}
+		else {
+			biquad_design_lowpass1_f32(c, sample_rate, (float)(sample_rate / M_PI * atan(t * sr)));
+		}
+		c += BIQUAD_COEFFS;
+	}
+	else if (design == IIR_FILTER_CHEBYSHEV1) {
+		// Even-order Chebyshev filters start at the bottom of the ripple band.
+		float g = powf(10.0f, -ripple_db / 20.0f);
+		first[0] *= g;
+		first[1] *= g;
+		first[2] *= g;
+	}
+
+	return c;
+}
+
+static inline int iir_filter_init_f32(int8_t* restrict state_bytes, int count, int sample_rate,
+	int response, int design, int order, float cutoff_freq, float low_cutoff_freq, float high_cutoff_freq, float ripple_db)
+{
+	int sections = (order + 1) / 2;
+	float fs = (float)sample_rate;
+
+	if (response == IIR_FILTER_BANDPASS) {
+		biquad_init_f32(state_bytes, count, 2 * sections);
+		float* c = biquad_coeffs_f32(state_bytes);
+		c = iir_filter_design_f32(c, 1, design, order, fs, low_cutoff_freq, ripple_db);
+		iir_filter_design_f32(c, 0, design, order, fs, high_cutoff_freq, ripple_db);
+	}
+	else {
+		biquad_init_f32(state_bytes, count, sections);
+		iir_filter_design_f32(biquad_coeffs_f32(state_bytes), response == IIR_FILTER_HIGHPASS, design, order, fs, cutoff_freq, ripple_db);
+	}
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "iir_filter_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_cascade_block_f32"
+
+static inline void iir_filter_f32(const float* restrict input, int8_t* restrict state_bytes,
+	float* restrict output, int frames)
+{
+	biquad_cascade_block_f32(input, state_bytes, output, frames);
+}
+
+#pragma IMAGINET_FRAGMENT_END
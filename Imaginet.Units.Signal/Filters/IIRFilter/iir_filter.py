@@ -0,0 +1,24 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+import numpy as np
+from scipy import signal
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "iir_filter"
+
+
+def iir_filter(input, output, response, design, order, cutoff_freq, low_cutoff_freq, high_cutoff_freq, ripple_db, freq):
+    def sos(btype, wn):
+        if design == 1:
+            return signal.cheby1(order, ripple_db, wn, btype, fs=freq, output="sos")
+        return signal.butter(order, wn, btype, fs=freq, output="sos")
+
+    if response == 2:
+        sections = np.vstack([sos("highpass", low_cutoff_freq), sos("lowpass", high_cutoff_freq)])
+    else:
+        sections = sos("highpass" if response == 1 else "lowpass", cutoff_freq)
+
+    result = signal.sosfilt(sections, input, axis=0)
+    np.copyto(output, result)
+
+
+#pragma IMAGINET_FRAGMENT_END
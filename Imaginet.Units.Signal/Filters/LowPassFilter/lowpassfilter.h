@@ -1,19 +1,33 @@
 #pragma IMAGINET_INCLUDES_BEGIN
 #include <stdint.h>
+#include <string.h>
 #include <math.h> // For expf() and M_PI
 #pragma IMAGINET_INCLUDES_END
 
-#pragma IMAGINET_FRAGMENT_BEGIN "lowpass_filter_f32"
+#pragma IMAGINET_FRAGMENT_BEGIN "lowpass_filter_init_f32"
 
-static inline void lowpass_filter_f32(const float* restrict input, int8_t* restrict state_bytes, float* restrict output, float cutoff_freq, int count, int freq)
+static inline int lowpass_filter_init_f32(int8_t* restrict state_bytes, float cutoff_freq, int count, int freq)
 {
-	// Cast the byte buffer to float array for accessing filter state
+	// The first float of the handle holds alpha, followed by one filter state value per element.
 	float* state = (float*)state_bytes;
-	
+
 	// Calculate alpha based on the cutoff frequency and the input data's frequency.
 	// A common formula for a first-order low-pass filter:
 	// alpha = 1 - exp(-2 * pi * cutoff_freq / sampling_freq)
-	float alpha = 1.0f - expf(-2.0f * M_PI * cutoff_freq / (float)freq);
+	state[0] = 1.0f - expf(-2.0f * M_PI * cutoff_freq / (float)freq);
+	memset(state + 1, 0, count * sizeof(float));
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "lowpass_filter_f32"
+
+static inline void lowpass_filter_f32(const float* restrict input, int8_t* restrict state_bytes, float* restrict output, int count)
+{
+	// Cast the byte buffer to float array for accessing filter state
+	float* state = (float*)state_bytes + 1;
+	const float alpha = ((const float*)state_bytes)[0];
 
 	for (int i = 0; i < count; ++i)
 	{
@@ -22,4 +36,4 @@ static inline void lowpass_filter_f32(const float* restrict input, int8_t* restr
 	}
 }
 
-#pragma IMAGINET_FRAGMENT_END
\ No newline at end of file
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,69 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "parametric_eq_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_design_f32"
+
+// Band types, matching the OneOf items of ParametricEQ.imunit.
+#define PARAMETRIC_EQ_OFF 0
+#define PARAMETRIC_EQ_PEAKING 1
+#define PARAMETRIC_EQ_LOW_SHELF 2
+#define PARAMETRIC_EQ_HIGH_SHELF 3
+#define PARAMETRIC_EQ_NOTCH 4
+
+static inline int parametric_eq_band_f32(float* restrict c, int type, float sample_rate, float frequency, float Q, float gain_db)
+{
+	switch (type) {
+	case PARAMETRIC_EQ_PEAKING:
+		biquad_design_peaking_f32(c, sample_rate, frequency, Q, gain_db);
+		return 1;
+	case PARAMETRIC_EQ_LOW_SHELF:
+		biquad_design_low_shelf_f32(c, sample_rate, frequency, Q, gain_db);
+		return 1;
+	case PARAMETRIC_EQ_HIGH_SHELF:
+		biquad_design_high_shelf_f32(c, sample_rate, frequency, Q, gain_db);
+		return 1;
+	case PARAMETRIC_EQ_NOTCH:
+		biquad_design_notch_f32(c, sample_rate, frequency, Q);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static inline int parametric_eq_init_f32(int8_t* restrict state_bytes, int count, int sample_rate,
+	int type1, float frequency1, float Q1, float gain_db1,
+	int type2, float frequency2, float Q2, float gain_db2,
+	int type3, float frequency3, float Q3, float gain_db3,
+	int type4, float frequency4, float Q4, float gain_db4)
+{
+	int sections = (type1 != PARAMETRIC_EQ_OFF) + (type2 != PARAMETRIC_EQ_OFF)
+		+ (type3 != PARAMETRIC_EQ_OFF) + (type4 != PARAMETRIC_EQ_OFF);
+
+	biquad_init_f32(state_bytes, count, sections);
+
+	// Active bands are packed to the front so that disabled bands cost nothing per frame.
+	float* c = biquad_coeffs_f32(state_bytes);
+	float fs = (float)sample_rate;
+	c += parametric_eq_band_f32(c, type1, fs, frequency1, Q1, gain_db1) * BIQUAD_COEFFS;
+	c += parametric_eq_band_f32(c, type2, fs, frequency2, Q2, gain_db2) * BIQUAD_COEFFS;
+	c += parametric_eq_band_f32(c, type3, fs, frequency3, Q3, gain_db3) * BIQUAD_COEFFS;
+	parametric_eq_band_f32(c, type4, fs, frequency4, Q4, gain_db4);
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "parametric_eq_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../Biquad/biquad.h:biquad_cascade_f32"
+
+static inline void parametric_eq_f32(const float* restrict input, int8_t* restrict state_bytes,
+	float* restrict output)
+{
+	biquad_cascade_f32(input, state_bytes, output);
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,182 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_t"
+
+// Handle layout (size = 32 + segments * 4 + count * 4 bytes):
+//   energy_gate_t header
+//   float segment_energy[segments]   sum of squares of every stride-sized segment of the window
+//   float frame[count]               last window that passed the gate, or silence
+typedef struct {
+	int32_t segments;		// Number of stride-sized segments in a window
+	int32_t head;			// Slot of the oldest segment, replaced by the next window's newest segment
+	int32_t primed;			// 0 until the first window has been measured in full
+	int32_t open;			// Gate state
+	int32_t below;			// Consecutive windows below the close threshold
+	int32_t pending;		// A window is waiting to be dequeued
+	int32_t silence_sent;	// The silence frame for the current closed period has been queued
+	int32_t skipped;		// Windows dropped since init
+} energy_gate_t;
+
+static inline float* energy_gate_segments(void* handle)
+{
+	return (float*)((char*)handle + sizeof(energy_gate_t));
+}
+
+static inline float* energy_gate_frame(void* handle)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+	return energy_gate_segments(handle) + gate->segments;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+// All fragments depend on this
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "energy_gate_t"
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_init"
+
+static inline void energy_gate_init(void* restrict handle, int segments)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+	memset(gate, 0, sizeof(energy_gate_t));
+	gate->segments = segments;
+	memset(energy_gate_segments(handle), 0, segments * sizeof(float));
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_enqueue_f32"
+
+static inline float energy_gate_sum_squares_f32(const float* restrict x, int count)
+{
+	float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		s0 += x[i] * x[i];
+		s1 += x[i + 1] * x[i + 1];
+		s2 += x[i + 2] * x[i + 2];
+		s3 += x[i + 3] * x[i + 3];
+	}
+	for (; i < count; i++) {
+		s0 += x[i] * x[i];
+	}
+	return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * Measure the energy of a window and update the gate.
+ *
+ * Consecutive windows from a Sliding Window overlap by count - stride elements, so only the
+ * newest stride elements are squared; the energy of the segment that slid out is dropped.
+ * The gate opens when the mean energy rises above open_db and closes after 'hangover'
+ * consecutive windows below close_db. An open window, and with emit_silence the first
+ * window of every closed period as all zeros, is queued for Dequeue; all others are counted.
+ *
+ * @return IPWIN_RET_SUCCESS (0)
+ */
+static inline int energy_gate_enqueue_f32(void* restrict handle, const float* restrict input, int count, int stride,
+	float open_db, float close_db, int hangover, int emit_silence)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+	float* seg = energy_gate_segments(handle);
+	const int segments = gate->segments;
+
+	if (!gate->primed) {
+		for (int s = 0; s < segments; s++) {
+			seg[s] = energy_gate_sum_squares_f32(input + s * stride, stride);
+		}
+		gate->head = 0;
+		gate->primed = 1;
+	}
+	else {
+		seg[gate->head] = energy_gate_sum_squares_f32(input + count - stride, stride);
+		gate->head++;
+		if (gate->head == segments)
+			gate->head = 0;
+	}
+
+	float energy = 0.0f;
+	for (int s = 0; s < segments; s++) {
+		energy += seg[s];
+	}
+	float level_db = 10.0f * log10f(energy / count + 1e-12f);
+
+	if (level_db > open_db) {
+		gate->open = 1;
+		gate->below = 0;
+	}
+	else if (gate->open && level_db < close_db) {
+		gate->below++;
+		if (gate->below >= hangover) {
+			gate->open = 0;
+			gate->silence_sent = 0;
+		}
+	}
+	else {
+		gate->below = 0;
+	}
+
+	float* frame = energy_gate_frame(handle);
+	if (gate->open) {
+		memcpy(frame, input, count * sizeof(float));
+		gate->pending = 1;
+	}
+	else if (emit_silence && !gate->silence_sent) {
+		memset(frame, 0, count * sizeof(float));
+		gate->silence_sent = 1;
+		gate->pending = 1;
+	}
+	else {
+		gate->skipped++;
+	}
+
+	return IPWIN_RET_SUCCESS;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_dequeue_f32"
+/*
+* Output the queued window and the number of windows skipped so far.
+*
+* @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1) if the gate dropped the last window.
+*/
+static inline int energy_gate_dequeue_f32(void* restrict handle, float* restrict output, int32_t* restrict skipped, int count)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+
+	if (!gate->pending)
+		return IPWIN_RET_NODATA;
+
+	memcpy(output, energy_gate_frame(handle), count * sizeof(float));
+	skipped[0] = gate->skipped;
+	gate->pending = 0;
+	return IPWIN_RET_SUCCESS;
+}
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_can_enqueue"
+
+static inline int energy_gate_can_enqueue(void* restrict handle)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+	return gate->pending ? IPWIN_RET_NODATA : IPWIN_RET_SUCCESS;
+}
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "energy_gate_can_dequeue"
+
+static inline int energy_gate_can_dequeue(void* restrict handle)
+{
+	energy_gate_t* gate = (energy_gate_t*)handle;
+	return gate->pending ? IPWIN_RET_SUCCESS : IPWIN_RET_NODATA;
+}
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,44 @@
+#pragma IMAGINET_FRAGMENT_BEGIN "polyphase_resample_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "polyphase_state.h:polyphase_state_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../Filters/FIRFilter/fir_filter.h:fir_mac_f32"
+
+// Resample a block of 'frames' input frames (time is the outermost axis) by L/M.
+// Output m sits at position m * M on the L-times upsampled grid; it is computed from the
+// latest 'taps' input frames with sub-filter (m * M) mod L, so the zero-stuffed samples
+// and the discarded outputs are never touched. A block of frames inputs always yields
+// frames * L / M outputs.
+static inline void polyphase_resample_f32(const float* restrict input, float* restrict output, int frames, void* state_ptr)
+{
+	polyphase_state_f32* state = (polyphase_state_f32*)state_ptr;
+	const int up = state->up;
+	const int down = state->down;
+	const int taps = state->taps;
+	const int count = state->count;
+	float* delay = polyphase_delay_f32(state_ptr);
+	const float* bank = polyphase_bank_f32(state_ptr);
+	int pos = state->pos;
+	int phase = state->phase;
+
+	for (int f = 0; f < frames; f++) {
+		const float* x = input + f * count;
+		memcpy(delay + pos * count, x, count * sizeof(float));
+		memcpy(delay + (pos + taps) * count, x, count * sizeof(float));
+
+		pos++;
+		if (pos == taps)
+			pos = 0;
+
+		// Emit every output that falls between this input frame and the next one.
+		while (phase < up) {
+			fir_mac_f32(delay + pos * count, bank + phase * taps, output, taps, count);
+			output += count;
+			phase += down;
+		}
+		phase -= up;
+	}
+
+	state->pos = pos;
+	state->phase = phase;
+}
+
+#pragma IMAGINET_FRAGMENT_END
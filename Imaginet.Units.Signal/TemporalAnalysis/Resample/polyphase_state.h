@@ -0,0 +1,84 @@
+#pragma IMAGINET_INCLUDES_BEGIN
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#pragma IMAGINET_INCLUDES_END
+
+#pragma IMAGINET_FRAGMENT_BEGIN "polyphase_state_f32"
+
+// Handle layout (size = 24 + 2 * taps * count * 4 + up * taps * 4 bytes):
+//   polyphase_state_f32 header
+//   float delay[2 * taps][count]     mirrored delay line, same scheme as fir_state_f32
+//   float bank[up][taps]             one sub-filter per output phase, stored time-reversed
+typedef struct {
+    int up;        // L: interpolation factor, out_frames / gcd(frames, out_frames)
+    int down;      // M: decimation factor, frames / gcd(frames, out_frames)
+    int taps;      // Taps per phase
+    int count;     // Channels per frame
+    int pos;       // Delay line slot of the next input frame, in [0, taps)
+    int phase;     // Upsampled-grid offset of the next output from the latest input frame, in [0, down)
+} polyphase_state_f32;
+
+static inline float* polyphase_delay_f32(void* state_ptr)
+{
+	return (float*)((char*)state_ptr + sizeof(polyphase_state_f32));
+}
+
+static inline float* polyphase_bank_f32(void* state_ptr)
+{
+	polyphase_state_f32* state = (polyphase_state_f32*)state_ptr;
+	return polyphase_delay_f32(state_ptr) + 2 * state->taps * state->count;
+}
+
+#pragma IMAGINET_FRAGMENT_END
+
+
+#pragma IMAGINET_FRAGMENT_BEGIN "polyphase_init_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "polyphase_state_f32"
+#pragma IMAGINET_FRAGMENT_DEPENDENCY "../../Filters/FIRFilter/fir_filter.h:fir_design_f32"
+
+// Reduce frames:out_frames to L:M and design the filter bank. The prototype is a Hamming
+// windowed-sinc low-pass of L * taps coefficients at the upsampled rate L * fs, cut off at the
+// lower of the two Nyquist frequencies. Phase p holds coefficients p, p + L, p + 2L, ...
+// scaled by L so that every phase has unit DC gain.
+static inline int polyphase_init_f32(int count, void* state_ptr, int frames, int out_frames, int taps)
+{
+	polyphase_state_f32* state = (polyphase_state_f32*)state_ptr;
+
+	int a = frames, b = out_frames;
+	while (b != 0) {
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+
+	const int up = out_frames / a;
+	const int down = frames / a;
+	state->up = up;
+	state->down = down;
+	state->taps = taps;
+	state->count = count;
+	state->pos = 0;
+	state->phase = 0;
+	memset(polyphase_delay_f32(state_ptr), 0, (size_t)2 * taps * count * sizeof(float));
+
+	const int length = up * taps;
+	const double fc = 0.5 / (up > down ? up : down);
+	float* bank = polyphase_bank_f32(state_ptr);
+
+	double sum = 0.0;
+	for (int n = 0; n < length; n++) {
+		double h = fir_sinc_f32(n, length, fc) * fir_window_f32(FIR_WINDOW_HAMMING, n, length);
+		int p = n % up;
+		int k = n / up;
+		bank[p * taps + (taps - 1 - k)] = (float)h;
+		sum += h;
+	}
+
+	for (int n = 0; n < length; n++) {
+		bank[n] = (float)(bank[n] * up / sum);
+	}
+	return 0;
+}
+
+#pragma IMAGINET_FRAGMENT_END
@@ -0,0 +1,31 @@
+/*
+* Imagimob AB CONFIDENTIAL
+* Unpublished Copyright (c) 2019- [Imagimob AB], All Rights Reserved.
+* NOTICE: All information contained herein is, and remains the property of Imagimob AB.
+*/
+
+namespace Imaginet.Units.Signal.SlidingWindow;
+
+public static class SlidingWindow
+{
+    /// <summary>
+    /// Window coefficients for the fused windowing dequeue, selected by the window_function option
+    /// (0 None, 1 Hann, 2 Hamming, 3 Blackman, 4 Blackman-Harris).
+    /// </summary>
+    /// <param name="window">Value of the window_function option.</param>
+    /// <param name="size">Number of rows along the outermost window axis.</param>
+    /// <param name="sym"> When True, generates a symmetric window, for use in filter design. 
+    /// When False, generates a periodic window, for use in spectral analysis.</param>
+    /// <returns>The window table, or a single unused coefficient when no window function is selected.</returns>
+    public static float[] WindowTableF32(int window, int size, bool sym)
+    {
+        return window switch
+        {
+            1 => Hann.Hann.HannTableF32(size, sym),
+            2 => Hamming.Hamming.HammingTableF32(size, sym),
+            3 => Blackman.Blackman.BlackmanTableF32(size, sym),
+            4 => BlackmanHarris.BlackmanHarris.BlackmanHarrisTableF32(size, sym),
+            _ => new float[] { 1.0f },
+        };
+    }
+}
@@ -87,6 +87,68 @@ static inline int fixwin_dequeue(void* restrict handle, void* restrict dst, int
 #pragma IMAGINET_FRAGMENT_END
 
 
+#pragma IMAGINET_FRAGMENT_BEGIN "fixwin_dequeue_window_f32"
+
+// Scale elements [begin, end) of the window while copying them: element e belongs to
+// window row e / row_len and is multiplied by w[e / row_len].
+static inline void fixwin_window_span_f32(const float* restrict src, float* restrict dst, const float* restrict w, int begin, int end, int row_len)
+{
+	if (row_len == 1) {
+		for (int e = begin; e < end; e++) {
+			dst[e] = src[e - begin] * w[e];
+		}
+		return;
+	}
+
+	int e = begin;
+	while (e < end) {
+		const int row = e / row_len;
+		const int row_end = (row + 1) * row_len < end ? (row + 1) * row_len : end;
+		const float wk = w[row];
+		for (; e < row_end; e++) {
+			dst[e] = src[e - begin] * wk;
+		}
+	}
+}
+
+/*
+* Try to dequeue a float32 window and apply a window function in the same pass.
+* The window is read straight out of the circular buffer (at most two contiguous segments),
+* so the data is only touched once instead of being copied and then scaled by a separate unit.
+*
+* @param handle Pointer to an initialized handle.
+* @param dst Pointer where to write the windowed data.
+* @param stride_count Number of items (of size handle->input_size) to stride window.
+* @param w Window coefficients, one per row of the outermost window axis.
+* @param row_len Number of elements in each row of the outermost window axis.
+* @return IPWIN_RET_SUCCESS (0) or IPWIN_RET_NODATA (-1) is no data is available.
+*/
+static inline int fixwin_dequeue_window_f32(void* restrict handle, float* restrict dst, int count, int stride_count, const float* restrict w, int row_len)
+{
+	fixwin_t* fep = (fixwin_t*)handle;
+
+	const int stride_bytes = stride_count * fep->input_size;
+	const int size = count * fep->input_size;
+	if (cbuffer_get_used(&fep->data_buffer) < size)
+		return IPWIN_RET_NODATA;
+
+	int can_read_bytes;
+	const float* src = (const float*)cbuffer_readptr(&fep->data_buffer, 0, &can_read_bytes);
+
+	const int n = size / (int)sizeof(float);
+	const int n0 = can_read_bytes < size ? can_read_bytes / (int)sizeof(float) : n;
+	fixwin_window_span_f32(src, dst, w, 0, n0, row_len);
+	if (n0 < n)
+		fixwin_window_span_f32((const float*)fep->data_buffer.buf, dst, w, n0, n, row_len);
+
+	if (cbuffer_advance(&fep->data_buffer, stride_bytes) != 0)
+		return IPWIN_RET_ERROR;
+
+	return IPWIN_RET_SUCCESS;
+}
+#pragma IMAGINET_FRAGMENT_END
+
+
 #pragma IMAGINET_FRAGMENT_BEGIN "fixwin_can_dequeue"
 
 static inline int fixwin_can_dequeue(void* restrict handle, int count)